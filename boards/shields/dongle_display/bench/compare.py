@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 The ZMK Contributors
+#
+# SPDX-License-Identifier: MIT
+#
+"""Compare the output of two benchmark runs, e.g. the LVGL and the lite renderer.
+
+Reads the bench lines of two logs and prints every update path side by side with the ratio of the
+second run to the first one.
+"""
+
+import argparse
+
+COLUMNS = ["update_avg_ns", "refresh_avg_ns", "refresh_max_ns", "bytes_avg"]
+
+
+def parse(path):
+    renderer = path
+    header = None
+    rows = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if fields[0] != "bench":
+                continue
+            if fields[1] == "renderer":
+                renderer = fields[2]
+            elif fields[1] == "path":
+                header = fields[1:]
+            elif header:
+                rows[fields[1]] = dict(zip(header, fields[1:]))
+    return renderer, rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline", help="log of the first run")
+    parser.add_argument("candidate", help="log of the second run")
+    args = parser.parse_args()
+
+    base_name, base = parse(args.baseline)
+    cand_name, cand = parse(args.candidate)
+
+    print(f"{'path':<16} {'column':<16} {base_name:>12} {cand_name:>12} {'ratio':>7}")
+    for path, row in base.items():
+        if path not in cand:
+            continue
+        for column in COLUMNS:
+            a = int(row[column])
+            b = int(cand[path][column])
+            ratio = f"{b / a:.2f}" if a else "-"
+            print(f"{path:<16} {column:<16} {a:>12} {b:>12} {ratio:>7}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/init.h>
+
+// The dummy display defaults to ARGB8888 while LVGL is configured for the 1 bpp SSD1306, switch
+// it over before LVGL queries the capabilities. It still does not report the SSD1306 page tiling,
+// see README.md for what that means for the benchmark figures.
+static int headless_display_init(void) {
+    const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+    if (!device_is_ready(display)) {
+        return -ENODEV;
+    }
+
+    return display_set_pixel_format(display, PIXEL_FORMAT_MONO10);
+}
+
+SYS_INIT(headless_display_init, POST_KERNEL, CONFIG_APPLICATION_INIT_PRIORITY);
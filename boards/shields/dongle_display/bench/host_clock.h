@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Monotonic host time. native_sim only advances simulated time while the CPU is idle, so
+// render cost has to be measured on the host clock.
+uint64_t dongle_bench_host_ns(void);
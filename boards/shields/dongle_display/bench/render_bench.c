@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <posix_board_if.h>
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/keymap.h>
+#include <dt-bindings/zmk/keys.h>
+
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+#include <zmk/events/hid_indicators_changed.h>
+#endif
+
+#include "display/pacer.h"
+#include "host_clock.h"
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE)
+#include "lite/framebuffer.h"
+
+#define RENDERER_NAME "lite"
+
+static uint64_t flushed_bytes(void) {
+    struct dongle_lite_stats stats;
+
+    dongle_lite_get_stats(&stats);
+    return stats.total_bytes;
+}
+
+static void refresh(void) { dongle_lite_flush(); }
+#else
+#include <lvgl.h>
+
+#include "display/flush_tracker.h"
+
+#define RENDERER_NAME "lvgl"
+
+static uint64_t flushed_bytes(void) {
+    struct dongle_flush_stats stats;
+
+    dongle_flush_get_stats(&stats);
+    return stats.total_bytes;
+}
+
+static void refresh(void) { lv_refr_now(NULL); }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+#include "display/heap.h"
+#include "display/widget.h"
+#endif
+
+enum bench_path {
+    BENCH_POSITION,
+    BENCH_LAYER,
+    BENCH_MODIFIER,
+    BENCH_BATTERY,
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    BENCH_HID_INDICATORS,
+#endif
+    BENCH_PATH_COUNT,
+};
+
+struct bench_result {
+    const char *name;
+    uint32_t samples;
+    uint64_t update_ns;
+    uint64_t update_max_ns;
+    uint64_t refresh_ns;
+    uint64_t refresh_max_ns;
+    uint64_t bytes;
+};
+
+static struct bench_result results[BENCH_PATH_COUNT] = {
+    [BENCH_POSITION] = {.name = "position"},
+    [BENCH_LAYER] = {.name = "layer"},
+    [BENCH_MODIFIER] = {.name = "modifier"},
+    [BENCH_BATTERY] = {.name = "battery"},
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    [BENCH_HID_INDICATORS] = {.name = "hid_indicators"},
+#endif
+};
+
+// one key on each half so the split cat alternates paws
+static const uint32_t positions[] = {1, 10};
+
+static K_SEM_DEFINE(frame_done, 0, 1);
+static uint64_t updated_at;
+static uint64_t refreshed_at;
+static uint64_t frame_bytes;
+
+// Applies the paced widget updates without waiting for the frame period, so only the refresh and
+// flush of the renderer are left afterwards.
+static void bench_frame_work_cb(struct k_work *work) {
+    dongle_pacer_flush();
+
+    updated_at = dongle_bench_host_ns();
+    uint64_t before = flushed_bytes();
+
+    refresh();
+
+    refreshed_at = dongle_bench_host_ns();
+    frame_bytes = flushed_bytes() - before;
+
+    k_sem_give(&frame_done);
+}
+
+K_WORK_DEFINE(bench_frame_work, bench_frame_work_cb);
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+
+static void print_heap_usage(const char *name, const struct dongle_heap_usage *usage) {
+    printk("heap,owner,%s,%u,%u,%u,%u,%d\n", name, usage->live_bytes, usage->peak_bytes,
+           usage->blocks, usage->allocs, usage->objects);
+}
+
+// On the display work queue, probing the pool must not race the LVGL refresh
+static void bench_heap_work_cb(struct k_work *work) {
+    struct dongle_heap_stats stats;
+
+    dongle_heap_get_stats(&stats);
+
+    printk("heap,pool,size,peak,live,largest_free,fragmentation_pct,lv_obj,failed\n");
+    printk("heap,pool,%u,%u,%u,%u,%u,%u,%u\n", CONFIG_LV_Z_MEM_POOL_SIZE, stats.pool_peak,
+           stats.pool_live, stats.pool_largest_free, stats.fragmentation_pct, stats.objects,
+           stats.failed);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+    printk("heap,arena,size,peak,live,fallbacks\n");
+    printk("heap,arena,%u,%u,%u,%u\n", CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA_SIZE,
+           stats.arena_peak, stats.arena_live, stats.arena_fallbacks);
+#endif
+    printk("heap,owner,name,live_bytes,peak_bytes,blocks,allocs,lv_obj\n");
+
+    STRUCT_SECTION_FOREACH(dongle_widget, widget) {
+        print_heap_usage(widget->name, &widget->state->heap);
+    }
+    print_heap_usage("lvgl", &stats.lvgl);
+
+    k_sem_give(&frame_done);
+}
+
+K_WORK_DEFINE(bench_heap_work, bench_heap_work_cb);
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS) */
+
+static void raise_scripted_event(enum bench_path path, uint32_t i) {
+    bool pressed = (i % 2) == 0;
+
+    switch (path) {
+    case BENCH_POSITION:
+        raise_zmk_position_state_changed((struct zmk_position_state_changed){
+            .source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+            .position = positions[(i / 2) % ARRAY_SIZE(positions)],
+            .state = pressed,
+            .timestamp = k_uptime_get()});
+        break;
+    case BENCH_LAYER:
+        if (pressed) {
+            zmk_keymap_layer_activate(1);
+        } else {
+            zmk_keymap_layer_deactivate(1);
+        }
+        break;
+    case BENCH_MODIFIER:
+        raise_zmk_keycode_state_changed_from_encoded((i / 2) % 2 ? LCTRL : LSHIFT, pressed,
+                                                     k_uptime_get());
+        break;
+    case BENCH_BATTERY:
+        raise_zmk_peripheral_battery_state_changed((struct zmk_peripheral_battery_state_changed){
+            .source = i % 2, .state_of_charge = 100 - ((i * 7) % 101)});
+        break;
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    case BENCH_HID_INDICATORS:
+        raise_zmk_hid_indicators_changed(
+            (struct zmk_hid_indicators_changed){.indicators = i % 8});
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+static void bench_step(enum bench_path path, uint32_t i) {
+    struct bench_result *result = &results[path];
+    uint64_t raised_at = dongle_bench_host_ns();
+
+    raise_scripted_event(path, i);
+    k_work_submit_to_queue(zmk_display_work_q(), &bench_frame_work);
+    k_sem_take(&frame_done, K_FOREVER);
+
+    uint64_t update_ns = updated_at - raised_at;
+    uint64_t refresh_ns = refreshed_at - updated_at;
+
+    result->samples++;
+    result->update_ns += update_ns;
+    result->update_max_ns = MAX(result->update_max_ns, update_ns);
+    result->refresh_ns += refresh_ns;
+    result->refresh_max_ns = MAX(result->refresh_max_ns, refresh_ns);
+    result->bytes += frame_bytes;
+}
+
+static void bench_report(void) {
+    printk("bench,renderer,%s\n", RENDERER_NAME);
+    printk("bench,path,samples,update_avg_ns,update_max_ns,refresh_avg_ns,refresh_max_ns,"
+           "bytes_avg\n");
+
+    for (int path = 0; path < BENCH_PATH_COUNT; path++) {
+        struct bench_result *result = &results[path];
+
+        if (result->samples == 0) {
+            continue;
+        }
+
+        printk("bench,%s,%u,%u,%u,%u,%u,%u\n", result->name, result->samples,
+               (uint32_t)(result->update_ns / result->samples), (uint32_t)result->update_max_ns,
+               (uint32_t)(result->refresh_ns / result->samples), (uint32_t)result->refresh_max_ns,
+               (uint32_t)(result->bytes / result->samples));
+    }
+}
+
+static void bench_thread(void *p1, void *p2, void *p3) {
+    while (!zmk_display_is_initialized()) {
+        k_msleep(10);
+    }
+
+    // let the initial full-screen paint go out before measuring
+    k_msleep(100);
+
+    for (int path = 0; path < BENCH_PATH_COUNT; path++) {
+        for (uint32_t i = 0; i < CONFIG_ZMK_DONGLE_DISPLAY_BENCHMARK_ITERATIONS; i++) {
+            bench_step(path, i);
+        }
+    }
+
+    bench_report();
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    k_work_submit_to_queue(zmk_display_work_q(), &bench_heap_work);
+    k_sem_take(&frame_done, K_FOREVER);
+#endif
+
+    posix_exit(0);
+}
+
+K_THREAD_DEFINE(dongle_render_bench, 2048, bench_thread, NULL, NULL, NULL,
+                K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
@@ -5,59 +5,111 @@
  */
 
  #include "custom_status_screen.h"
- #include "widgets/battery_status.h"
- #include "widgets/modifiers.h"
- #include "widgets/split_bongo_cat.h"  // Updated to use our new widget
- #include "widgets/layer_status.h"
- #include "widgets/output_status.h"
- #include "widgets/hid_indicators.h"
+ #include "display/async_flush.h"
+ #include "display/display_power.h"
+ #include "display/flush_tracker.h"
+ #include "display/heap.h"
+ #include "display/text_cache.h"
+ #include "display/widget.h"
  
  #include <zephyr/logging/log.h>
  LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
- 
- static struct zmk_widget_output_status output_status_widget;
- static struct zmk_widget_layer_status layer_status_widget;
- static struct zmk_widget_dongle_battery_status dongle_battery_status_widget;
- static struct zmk_widget_modifiers modifiers_widget;
- static struct zmk_widget_split_bongo_cat split_bongo_cat_widget;  // Changed to our new widget
- 
- #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
- static struct zmk_widget_hid_indicators hid_indicators_widget;
+
+ #if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SUBSET_FONT)
+ // generated at build time with only the glyphs of the layer names and widget texts
+ LV_FONT_DECLARE(dongle_font);
+ #define STATUS_FONT dongle_font
+ #else
+ #define STATUS_FONT lv_font_unscii_8
  #endif
  
- lv_style_t global_style;
+ static const lv_style_const_prop_t global_props[] = {
+     LV_STYLE_CONST_TEXT_FONT(&STATUS_FONT),
+     LV_STYLE_CONST_TEXT_LETTER_SPACE(1),
+     LV_STYLE_CONST_TEXT_LINE_SPACE(1),
+     LV_STYLE_PROP_INV,
+ };
+
+ // const, the properties are read from flash and never take LVGL heap
+ static LV_STYLE_CONST_INIT(global_style, global_props);
+
+ static lv_obj_t *status_screen;
+ static bool ambient;
+
+ // widgets position their objects from the layout themselves, nothing is aligned here
+ static void create_widget(const struct dongle_widget *widget, lv_obj_t *screen) {
+     dongle_heap_enter(widget, DONGLE_HEAP_BUILD);
+     widget->state->obj = widget->create(screen);
+     dongle_heap_leave();
+     __ASSERT(widget->state->obj != NULL ||
+                  (widget->flags & (DONGLE_WIDGET_AMBIENT | DONGLE_WIDGET_UNLOAD)),
+              "%s has no object to hide on the ambient screen", widget->name);
+     dongle_flush_track(widget->region, widget->name, &widget->rect);
+     dongle_widget_activate(widget);
+ }
+
+ static void destroy_widget(const struct dongle_widget *widget) {
+     dongle_widget_deactivate(widget);
+     dongle_flush_track(widget->region, widget->name, NULL);
+     dongle_heap_enter(widget, DONGLE_HEAP_BUILD);
+     widget->destroy();
+     dongle_heap_leave();
+     widget->state->obj = NULL;
+ }
+
+ void dongle_status_screen_set_ambient(bool enable) {
+     if (status_screen == NULL || enable == ambient) {
+         return;
+     }
+
+     ambient = enable;
+
+     // ambient keeps only the battery and layer widgets, the animated ones are deleted outright
+     STRUCT_SECTION_FOREACH(dongle_widget, widget) {
+         if (widget->flags & DONGLE_WIDGET_AMBIENT) {
+             continue;
+         }
+
+         if (widget->flags & DONGLE_WIDGET_UNLOAD) {
+             if (ambient) {
+                 destroy_widget(widget);
+             } else {
+                 create_widget(widget, status_screen);
+             }
+         } else if (ambient) {
+             lv_obj_add_flag(widget->state->obj, LV_OBJ_FLAG_HIDDEN);
+         } else {
+             lv_obj_clear_flag(widget->state->obj, LV_OBJ_FLAG_HIDDEN);
+         }
+     }
+ }
  
  lv_obj_t *zmk_display_status_screen() {
      lv_obj_t *screen;
  
      screen = lv_obj_create(NULL);
  
-     lv_style_init(&global_style);
-     lv_style_set_text_font(&global_style, &lv_font_unscii_8);
-     lv_style_set_text_letter_space(&global_style, 1);
-     lv_style_set_text_line_space(&global_style, 1);
-     lv_obj_add_style(screen, &global_style, LV_PART_MAIN);
-     
-     // zmk_widget_output_status_init(&output_status_widget, screen);
-     // lv_obj_align(zmk_widget_output_status_obj(&output_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
-     
-     zmk_widget_split_bongo_cat_init(&split_bongo_cat_widget, screen);
-     lv_obj_align(zmk_widget_split_bongo_cat_obj(&split_bongo_cat_widget), LV_ALIGN_BOTTOM_RIGHT, 0, 0);
- 
-     zmk_widget_modifiers_init(&modifiers_widget, screen);
-     lv_obj_align(zmk_widget_modifiers_obj(&modifiers_widget), LV_ALIGN_BOTTOM_LEFT, 0, 0);
- 
- #if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
-     zmk_widget_hid_indicators_init(&hid_indicators_widget, screen);
-     lv_obj_align_to(zmk_widget_hid_indicators_obj(&hid_indicators_widget), 
-                     zmk_widget_modifiers_obj(&modifiers_widget), LV_ALIGN_OUT_TOP_LEFT, 0, -2);
- #endif
- 
-     zmk_widget_layer_status_init(&layer_status_widget, screen);
-     lv_obj_align(zmk_widget_layer_status_obj(&layer_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
- 
-     zmk_widget_dongle_battery_status_init(&dongle_battery_status_widget, screen);
-     lv_obj_align(zmk_widget_dongle_battery_status_obj(&dongle_battery_status_widget), LV_ALIGN_TOP_RIGHT, 0, 0);
- 
+     lv_obj_add_style(screen, (lv_style_t *)&global_style, LV_PART_MAIN);
+
+     int err = dongle_async_flush_init(lv_disp_get_default());
+     if (err && err != -ENOTSUP) {
+         LOG_WRN("Async flush unavailable (%d)", err);
+     }
+
+     err = dongle_flush_tracker_init(lv_disp_get_default());
+     if (err) {
+         LOG_WRN("Flush tracking unavailable (%d)", err);
+     }
+
+     dongle_text_cache_init();
+
+     // every widget compiled in, in registration order
+     STRUCT_SECTION_FOREACH(dongle_widget, widget) {
+         create_widget(widget, screen);
+     }
+
+     status_screen = screen;
+     dongle_display_power_init();
+
      return screen;
  }
\ No newline at end of file
@@ -9,4 +9,7 @@
 
 #include <lvgl.h>
 
-lv_obj_t *zmk_display_status_screen();
\ No newline at end of file
+lv_obj_t *zmk_display_status_screen();
+
+// Switches between the full status screen and the ambient one that only shows battery and layer.
+void dongle_status_screen_set_ambient(bool enable);
\ No newline at end of file
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "anim_engine.h"
+
+static inline const struct dongle_anim_state *current(const struct dongle_anim_instance *anim) {
+    return &anim->def->states[anim->state];
+}
+
+// Arms the deadline for whichever comes first: the next frame or the state timeout.
+static void arm(struct dongle_anim_instance *anim) {
+    const struct dongle_anim_state *state = current(anim);
+    int64_t due = INT64_MAX;
+
+    bool animated = state->frame_ms > 0 && state->frame_count > 1 &&
+                    !(state->once && anim->frame_index == state->frame_count - 1);
+    if (animated) {
+        // absolute frame boundaries so that late wakeups do not accumulate drift
+        int64_t elapsed = k_uptime_get() - anim->state_entered;
+        due = anim->state_entered + (elapsed / state->frame_ms + 1) * state->frame_ms;
+    }
+
+    if (state->timeout_ms > 0) {
+        due = MIN(due, anim->state_entered + state->timeout_ms);
+    }
+
+    if (due == INT64_MAX) {
+        dongle_anim_cancel(&anim->deadline);
+    } else {
+        dongle_anim_schedule_at(&anim->deadline, due);
+    }
+}
+
+static void enter(struct dongle_anim_instance *anim, uint8_t state) {
+    if (state >= anim->def->state_count) {
+        LOG_WRN("anim: no state %u", state);
+        return;
+    }
+
+    anim->state = state;
+    anim->frame_index = 0;
+    anim->state_entered = k_uptime_get();
+
+    anim->show(anim, current(anim)->frames[0]);
+    arm(anim);
+}
+
+static void deadline_cb(struct dongle_anim_deadline *deadline) {
+    struct dongle_anim_instance *anim =
+        CONTAINER_OF(deadline, struct dongle_anim_instance, deadline);
+    const struct dongle_anim_state *state = current(anim);
+    int64_t elapsed = k_uptime_get() - anim->state_entered;
+
+    if (state->timeout_ms > 0 && elapsed >= state->timeout_ms) {
+        enter(anim, state->timeout_state);
+        return;
+    }
+
+    if (state->frame_ms > 0) {
+        uint32_t frame = elapsed / state->frame_ms;
+
+        // skipped frames while the queue was busy are dropped, not replayed
+        frame = state->once ? MIN(frame, state->frame_count - 1) : frame % state->frame_count;
+        if (frame != anim->frame_index) {
+            anim->frame_index = frame;
+            anim->show(anim, state->frames[frame]);
+        }
+    }
+
+    arm(anim);
+}
+
+void dongle_anim_init(struct dongle_anim_instance *anim, const struct dongle_anim_def *def,
+                      dongle_anim_show_t show) {
+    anim->def = def;
+    anim->show = show;
+    dongle_anim_deadline_init(&anim->deadline, deadline_cb);
+
+    enter(anim, def->initial_state);
+}
+
+void dongle_anim_input(struct dongle_anim_instance *anim, uint8_t input, bool restart) {
+    const struct dongle_anim_def *def = anim->def;
+
+    for (int i = 0; i < def->transition_count; i++) {
+        const struct dongle_anim_transition *t = &def->transitions[i];
+
+        if (t->input != input || (t->from != DONGLE_ANIM_ANY && t->from != anim->state)) {
+            continue;
+        }
+
+        if (t->to != anim->state || restart) {
+            enter(anim, t->to);
+        }
+        return;
+    }
+}
+
+void dongle_anim_stop(struct dongle_anim_instance *anim) { dongle_anim_cancel(&anim->deadline); }
+
+uint8_t dongle_anim_bucket(const uint8_t *thresholds, uint8_t count, uint8_t value) {
+    uint8_t i = 0;
+
+    while (i < count && value >= thresholds[i]) {
+        i++;
+    }
+
+    return i;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include "anim_sched.h"
+
+// Table-driven frame animations. An animation is a const set of states, each with a frame
+// sequence and an optional timeout transition, plus a list of input transitions. Everything runs
+// on integer milliseconds and one deadline per instance, armed only while a state has another
+// frame or a timeout pending.
+
+#define DONGLE_ANIM_ANY 0xff
+
+struct dongle_anim_state {
+    const uint8_t *frames;
+    uint8_t frame_count;
+    // time each frame is shown, 0 holds the first frame for as long as the state lasts
+    uint16_t frame_ms;
+    // play the sequence once and hold the last frame instead of looping
+    bool once;
+    // move to timeout_state after timeout_ms in this state, 0 never times out
+    uint16_t timeout_ms;
+    uint8_t timeout_state;
+};
+
+struct dongle_anim_transition {
+    // current state or DONGLE_ANIM_ANY
+    uint8_t from;
+    uint8_t input;
+    uint8_t to;
+};
+
+struct dongle_anim_def {
+    const struct dongle_anim_state *states;
+    uint8_t state_count;
+    const struct dongle_anim_transition *transitions;
+    uint8_t transition_count;
+    uint8_t initial_state;
+};
+
+#define DONGLE_ANIM_FRAMES(...) .frames = (const uint8_t[]){__VA_ARGS__},                        \
+                                .frame_count = sizeof((const uint8_t[]){__VA_ARGS__})
+
+struct dongle_anim_instance;
+
+typedef void (*dongle_anim_show_t)(struct dongle_anim_instance *anim, uint8_t frame);
+
+// All runtime state of one animation, owned by the caller. Embed it in whatever show draws into
+// and find that again with CONTAINER_OF, any number of instances run side by side.
+struct dongle_anim_instance {
+    const struct dongle_anim_def *def;
+    dongle_anim_show_t show;
+    struct dongle_anim_deadline deadline;
+    uint8_t state;
+    uint8_t frame_index;
+    int64_t state_entered;
+};
+
+// Enters the initial state and shows its first frame.
+void dongle_anim_init(struct dongle_anim_instance *anim, const struct dongle_anim_def *def,
+                      dongle_anim_show_t show);
+
+// Applies the first transition matching the current state and input. Entering the state that is
+// already current keeps its sequence running, unless restart is set.
+void dongle_anim_input(struct dongle_anim_instance *anim, uint8_t input, bool restart);
+
+// Stops the deadline, the instance can be started again with dongle_anim_init.
+void dongle_anim_stop(struct dongle_anim_instance *anim);
+
+// Index of the first threshold value is below, or count if it is not below any: maps a level such
+// as WPM onto a small input alphabet with a const threshold table.
+uint8_t dongle_anim_bucket(const uint8_t *thresholds, uint8_t count, uint8_t value);
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "anim_sched.h"
+#include "stats.h"
+
+static sys_slist_t deadlines = SYS_SLIST_STATIC_INIT(&deadlines);
+static bool suspended;
+
+static atomic_t wakeups;
+static uint32_t reported_wakeups;
+static int64_t reported_at;
+
+static void deadline_work_cb(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct dongle_anim_deadline *deadline = CONTAINER_OF(dwork, struct dongle_anim_deadline, work);
+
+    deadline->due = 0;
+    atomic_inc(&wakeups);
+    deadline->handler(deadline);
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_STATS)
+    // animations may wake the CPU without flushing anything, report from here as well
+    dongle_stats_tick();
+#endif
+}
+
+void dongle_anim_deadline_init(struct dongle_anim_deadline *deadline,
+                               dongle_anim_handler_t handler) {
+    bool registered = deadline->handler != NULL;
+
+    deadline->handler = handler;
+    deadline->due = 0;
+    k_work_init_delayable(&deadline->work, deadline_work_cb);
+
+    if (!registered) {
+        sys_slist_append(&deadlines, &deadline->node);
+    }
+}
+
+void dongle_anim_schedule_at(struct dongle_anim_deadline *deadline, int64_t uptime_ms) {
+    deadline->due = uptime_ms;
+
+    if (suspended) {
+        return;
+    }
+
+    k_work_reschedule_for_queue(zmk_display_work_q(), &deadline->work,
+                                K_TIMEOUT_ABS_MS(uptime_ms));
+}
+
+void dongle_anim_cancel(struct dongle_anim_deadline *deadline) {
+    deadline->due = 0;
+    k_work_cancel_delayable(&deadline->work);
+}
+
+void dongle_anim_suspend(void) {
+    struct dongle_anim_deadline *deadline;
+
+    suspended = true;
+
+    // keep due, the deadline is re-armed on resume
+    SYS_SLIST_FOR_EACH_CONTAINER(&deadlines, deadline, node) {
+        k_work_cancel_delayable(&deadline->work);
+    }
+}
+
+void dongle_anim_resume(void) {
+    struct dongle_anim_deadline *deadline;
+
+    suspended = false;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&deadlines, deadline, node) {
+        if (deadline->due != 0) {
+            k_work_reschedule_for_queue(zmk_display_work_q(), &deadline->work,
+                                        K_TIMEOUT_ABS_MS(deadline->due));
+        }
+    }
+}
+
+uint32_t dongle_anim_wakeups(void) { return atomic_get(&wakeups); }
+
+void dongle_anim_log_stats(void) {
+    int64_t now = k_uptime_get();
+    uint32_t total = atomic_get(&wakeups);
+    uint32_t per_minute = 0;
+
+    if (now > reported_at) {
+        per_minute = (uint32_t)(((uint64_t)(total - reported_wakeups) * 60000) / (now - reported_at));
+    }
+
+    LOG_INF("anim: %u wakeups, %u/min since last report", total, per_minute);
+
+    reported_wakeups = total;
+    reported_at = now;
+}
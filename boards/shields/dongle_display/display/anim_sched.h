@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct dongle_anim_deadline;
+
+typedef void (*dongle_anim_handler_t)(struct dongle_anim_deadline *deadline);
+
+// A one-shot deadline run on the display work queue. Nothing is armed until a widget has a
+// pending state transition, so an idle screen does not wake the CPU at all.
+struct dongle_anim_deadline {
+    struct k_work_delayable work;
+    dongle_anim_handler_t handler;
+    sys_snode_t node;
+    // absolute uptime the deadline is armed for, 0 when disarmed
+    int64_t due;
+};
+
+void dongle_anim_deadline_init(struct dongle_anim_deadline *deadline,
+                               dongle_anim_handler_t handler);
+
+// Arms the deadline for an absolute uptime in milliseconds, replacing any pending one.
+void dongle_anim_schedule_at(struct dongle_anim_deadline *deadline, int64_t uptime_ms);
+
+void dongle_anim_cancel(struct dongle_anim_deadline *deadline);
+
+// While suspended deadlines are only recorded, resuming arms them again and runs the ones that
+// expired in the meantime right away.
+void dongle_anim_suspend(void);
+void dongle_anim_resume(void);
+
+uint32_t dongle_anim_wakeups(void);
+void dongle_anim_log_stats(void);
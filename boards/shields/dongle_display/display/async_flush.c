@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "async_flush.h"
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+
+#if DT_PROP_OR(DISPLAY_NODE, sh1106_compatible, 0)
+#error "Async flush only supports the SSD1306 addressing scheme"
+#endif
+
+#define PAGE_HEIGHT 8
+
+#define SSD1306_CONTROL_ALL_BYTES_CMD 0x00
+#define SSD1306_CONTROL_ALL_BYTES_DATA 0x40
+#define SSD1306_SET_MEM_ADDRESSING_MODE 0x20
+#define SSD1306_ADDRESSING_MODE_HORIZONTAL 0x00
+#define SSD1306_SET_COLUMN_ADDRESS 0x21
+#define SSD1306_SET_PAGE_ADDRESS 0x22
+
+#define SEGMENT_OFFSET DT_PROP_OR(DISPLAY_NODE, segment_offset, 0)
+#define PAGE_OFFSET DT_PROP_OR(DISPLAY_NODE, page_offset, 0)
+
+// Upper bound for one window, the page rounder keeps LVGL well below it
+#define FLUSH_TIMEOUT_MS 100
+
+#define FLUSH_THREAD_STACK_SIZE 512
+#define FLUSH_THREAD_PRIORITY 4
+
+#define DRAW_BUF_BYTES (DT_PROP(DISPLAY_NODE, width) * CONFIG_ZMK_DONGLE_DISPLAY_ASYNC_FLUSH_PAGES)
+
+BUILD_ASSERT(CONFIG_ZMK_DONGLE_DISPLAY_ASYNC_FLUSH_PAGES * PAGE_HEIGHT <=
+                 DT_PROP(DISPLAY_NODE, height),
+             "async draw buffers taller than the panel only waste RAM");
+
+static const struct i2c_dt_spec bus = I2C_DT_SPEC_GET(DISPLAY_NODE);
+
+// The data control byte sits right in front of the pixels so that a window goes out as a single
+// write message straight from the draw buffer, without the bus driver concatenating anything.
+struct draw_buf {
+    uint8_t reserved[3];
+    uint8_t control;
+    uint8_t pixels[DRAW_BUF_BYTES];
+} __aligned(4);
+
+static struct draw_buf draw_bufs[2];
+
+// The messages must stay valid until the transfer completes, only one window is ever in flight
+static uint8_t window_cmd[] = {
+    SSD1306_CONTROL_ALL_BYTES_CMD,
+    SSD1306_SET_MEM_ADDRESSING_MODE,
+    SSD1306_ADDRESSING_MODE_HORIZONTAL,
+    SSD1306_SET_COLUMN_ADDRESS,
+    0,
+    0,
+    SSD1306_SET_PAGE_ADDRESS,
+    0,
+    0,
+};
+static struct i2c_msg cmd_msg;
+static struct i2c_msg data_msg;
+
+static lv_disp_drv_t *in_flight;
+static bool in_flight_last;
+static bool use_callback = IS_ENABLED(CONFIG_I2C_CALLBACK);
+static bool installed;
+static void (*frame_sent_cb)(void);
+
+static K_SEM_DEFINE(window_ready, 0, 1);
+static K_SEM_DEFINE(flush_done, 0, 1);
+
+static uint32_t windows;
+static uint32_t errors;
+static uint32_t waits;
+
+static void finish_window(int result) {
+    lv_disp_drv_t *drv = in_flight;
+
+    if (result < 0) {
+        errors++;
+    }
+
+    in_flight = NULL;
+    // before the flush ready, LVGL must not start the next frame before this one is closed
+    if (in_flight_last && frame_sent_cb != NULL) {
+        frame_sent_cb();
+    }
+    // safe from interrupt context, only clears the flushing flags of the draw buffer
+    lv_disp_flush_ready(drv);
+    k_sem_give(&flush_done);
+}
+
+#if IS_ENABLED(CONFIG_I2C_CALLBACK)
+static void data_done_cb(const struct device *dev, int result, void *user_data) {
+    finish_window(result);
+}
+
+static void cmd_done_cb(const struct device *dev, int result, void *user_data) {
+    if (result < 0) {
+        finish_window(result);
+        return;
+    }
+
+    result = i2c_transfer_cb(bus.bus, &data_msg, 1, bus.addr, data_done_cb, NULL);
+    if (result < 0) {
+        finish_window(result);
+    }
+}
+#endif
+
+// Fallback for bus drivers without the callback API: a thread blocks on the DMA transfer
+// instead of the display work queue.
+static void flush_thread(void *p1, void *p2, void *p3) {
+    while (true) {
+        k_sem_take(&window_ready, K_FOREVER);
+
+        int result = i2c_transfer(bus.bus, &cmd_msg, 1, bus.addr);
+        if (result == 0) {
+            result = i2c_transfer(bus.bus, &data_msg, 1, bus.addr);
+        }
+
+        finish_window(result);
+    }
+}
+
+K_THREAD_DEFINE(dongle_async_flush, FLUSH_THREAD_STACK_SIZE, flush_thread, NULL, NULL, NULL,
+                FLUSH_THREAD_PRIORITY, 0, 0);
+
+static void async_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    uint16_t width = lv_area_get_width(area);
+
+    // the buffer is already in the vertically tiled page layout of the controller
+    window_cmd[4] = area->x1 + SEGMENT_OFFSET;
+    window_cmd[5] = area->x2 + SEGMENT_OFFSET;
+    window_cmd[7] = area->y1 / PAGE_HEIGHT + PAGE_OFFSET;
+    window_cmd[8] = area->y2 / PAGE_HEIGHT + PAGE_OFFSET;
+
+    // color_p is always the start of one of our draw buffers, include its control byte
+    data_msg.buf = (uint8_t *)color_p - 1;
+    data_msg.len = 1 + width * (lv_area_get_height(area) / PAGE_HEIGHT);
+
+    in_flight = drv;
+    in_flight_last = lv_disp_flush_is_last(drv);
+    windows++;
+
+#if IS_ENABLED(CONFIG_I2C_CALLBACK)
+    if (use_callback) {
+        int err = i2c_transfer_cb(bus.bus, &cmd_msg, 1, bus.addr, cmd_done_cb, NULL);
+
+        if (err != -ENOSYS) {
+            if (err < 0) {
+                finish_window(err);
+            }
+            return;
+        }
+
+        LOG_INF("I2C bus has no callback API, flushing from a thread");
+        use_callback = false;
+    }
+#endif
+
+    k_sem_give(&window_ready);
+}
+
+static void async_wait_cb(lv_disp_drv_t *drv) {
+    // LVGL polls the flushing flag, sleep until the transfer completion instead of spinning
+    waits++;
+    k_sem_take(&flush_done, K_MSEC(FLUSH_TIMEOUT_MS));
+}
+
+int dongle_async_flush_init(lv_disp_t *disp) {
+    if (disp == NULL || disp->driver == NULL) {
+        return -ENODEV;
+    }
+
+    if (!i2c_is_ready_dt(&bus)) {
+        return -ENODEV;
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(draw_bufs); i++) {
+        draw_bufs[i].control = SSD1306_CONTROL_ALL_BYTES_DATA;
+    }
+
+    // pixel count as LVGL sees it, the 1 bpp set_px callback packs eight of them per byte
+    lv_disp_draw_buf_init(disp->driver->draw_buf, draw_bufs[0].pixels, draw_bufs[1].pixels,
+                          DRAW_BUF_BYTES * 8);
+
+    cmd_msg = (struct i2c_msg){
+        .buf = window_cmd,
+        .len = sizeof(window_cmd),
+        .flags = I2C_MSG_WRITE | I2C_MSG_STOP,
+    };
+    data_msg.flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+
+    disp->driver->flush_cb = async_flush_cb;
+    disp->driver->wait_cb = async_wait_cb;
+    installed = true;
+
+    return 0;
+}
+
+int dongle_async_flush_on_frame_sent(void (*cb)(void)) {
+    if (!installed) {
+        return -ENODEV;
+    }
+
+    frame_sent_cb = cb;
+    return 0;
+}
+
+void dongle_async_flush_log_stats(void) {
+    LOG_INF("async flush: %u windows, %u errors, %u waits, %s", windows, errors, waits,
+            use_callback ? "callback" : "thread");
+}
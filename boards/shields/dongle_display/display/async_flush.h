@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_ASYNC_FLUSH)
+
+// Replaces the flush callback of the SSD1306 display driver with one that starts the I2C transfer
+// of the rendered page window and returns at once. lv_disp_flush_ready is signalled from the
+// transfer completion, so LVGL renders into its second draw buffer while the first is sent.
+// Installs its own pair of draw buffers. Must run before dongle_flush_tracker_init so that the
+// tracker wraps the async callback.
+int dongle_async_flush_init(lv_disp_t *disp);
+
+// Runs cb once the last window of a frame has reached the controller, from the transfer
+// completion interrupt or the flush thread. Returns -ENODEV unless the async flush is installed.
+int dongle_async_flush_on_frame_sent(void (*cb)(void));
+
+void dongle_async_flush_log_stats(void);
+
+#else
+
+static inline int dongle_async_flush_init(lv_disp_t *disp) { return -ENOTSUP; }
+static inline int dongle_async_flush_on_frame_sent(void (*cb)(void)) { return -ENOTSUP; }
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/drivers/i2c.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <lvgl.h>
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+#include "anim_sched.h"
+#include "custom_status_screen.h"
+#include "display_power.h"
+#include "latency.h"
+#include "pacer.h"
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+
+static enum dongle_display_power power = DONGLE_DISPLAY_POWER_ON;
+// the ambient layout stays loaded while blanked from ambient
+static bool ambient_layout;
+static uint32_t suspends;
+static uint32_t ambient_entries;
+static int64_t suspended_ms;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT)
+
+#define SSD1306_CONTROL_ALL_BYTES_CMD 0x00
+#define SSD1306_SET_MULTIPLEX_RATIO 0xA8
+
+#ifdef CONFIG_SSD1306_DEFAULT_CONTRAST
+#define FULL_CONTRAST CONFIG_SSD1306_DEFAULT_CONTRAST
+#else
+#define FULL_CONTRAST 128
+#endif
+
+// k_uptime_get_32 of the last key press, written by the listener and read on the display queue.
+// 32 bits so that the reads cannot tear, the idle times compared against it are far shorter.
+static atomic_t last_activity;
+
+static uint32_t idle_ms(void) { return k_uptime_get_32() - (uint32_t)atomic_get(&last_activity); }
+
+static void set_panel(uint8_t contrast, uint8_t multiplex) {
+    const struct device *display = DEVICE_DT_GET(DISPLAY_NODE);
+
+    display_set_contrast(display, contrast);
+
+#if DT_NODE_HAS_COMPAT(DISPLAY_NODE, solomon_ssd1306fb) && DT_ON_BUS(DISPLAY_NODE, i2c)
+    // not part of the display API, fewer driven COM lines is where most of the panel power goes
+    static const struct i2c_dt_spec bus = I2C_DT_SPEC_GET(DISPLAY_NODE);
+    uint8_t cmd[] = {SSD1306_SET_MULTIPLEX_RATIO, multiplex};
+
+    i2c_burst_write_dt(&bus, SSD1306_CONTROL_ALL_BYTES_CMD, cmd, sizeof(cmd));
+#endif
+}
+
+static void ambient_frame(void) {
+    // LVGL timers are off in ambient mode, paint the batch the pacer just applied
+    lv_refr_now(NULL);
+}
+
+static void enter_ambient(void) {
+    ambient_layout = true;
+    ambient_entries++;
+
+    lv_timer_enable(false);
+    dongle_status_screen_set_ambient(true);
+    dongle_pacer_set_period(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_REFRESH * 1000, ambient_frame);
+    set_panel(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_CONTRAST,
+              CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_MULTIPLEX);
+
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    LOG_DBG("display ambient");
+}
+
+static void leave_ambient(void) {
+    ambient_layout = false;
+
+    set_panel(FULL_CONTRAST, DT_PROP(DISPLAY_NODE, height) - 1);
+    dongle_pacer_set_period(0, NULL);
+    dongle_status_screen_set_ambient(false);
+    lv_timer_enable(true);
+    lv_obj_invalidate(lv_scr_act());
+}
+
+static void ambient_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(ambient_work, ambient_work_cb);
+
+static void arm_ambient(void) {
+    uint32_t idle = MIN(idle_ms(), CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_TIMEOUT);
+
+    k_work_reschedule_for_queue(zmk_display_work_q(), &ambient_work,
+                                K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_TIMEOUT - idle));
+}
+
+static void ambient_work_cb(struct k_work *work) {
+    if (power != DONGLE_DISPLAY_POWER_ON) {
+        return;
+    }
+
+    // key presses only move last_activity, the deadline catches up lazily
+    if (idle_ms() < CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_TIMEOUT) {
+        arm_ambient();
+        return;
+    }
+
+    power = DONGLE_DISPLAY_POWER_AMBIENT;
+    enter_ambient();
+}
+
+static void activity_work_cb(struct k_work *work) {
+    if (power != DONGLE_DISPLAY_POWER_AMBIENT) {
+        return;
+    }
+
+    power = DONGLE_DISPLAY_POWER_ON;
+    leave_ambient();
+    arm_ambient();
+}
+
+static K_WORK_DEFINE(activity_work, activity_work_cb);
+
+static int key_listener(const zmk_event_t *eh) {
+    atomic_set(&last_activity, k_uptime_get_32());
+
+    if (power == DONGLE_DISPLAY_POWER_AMBIENT) {
+        k_work_submit_to_queue(zmk_display_work_q(), &activity_work);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_display_ambient, key_listener);
+ZMK_SUBSCRIPTION(dongle_display_ambient, zmk_position_state_changed);
+
+#else
+
+static inline void leave_ambient(void) {}
+static inline void arm_ambient(void) {}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT) */
+
+void dongle_display_power_init(void) {
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT)
+    atomic_set(&last_activity, k_uptime_get_32());
+    arm_ambient();
+#endif
+}
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SUSPEND_ON_BLANK)
+
+static int64_t suspended_at;
+
+static void suspend_work_cb(struct k_work *work) {
+    if (power == DONGLE_DISPLAY_POWER_OFF) {
+        return;
+    }
+
+    power = DONGLE_DISPLAY_POWER_OFF;
+    suspends++;
+    suspended_at = k_uptime_get();
+
+    dongle_pacer_suspend();
+    dongle_anim_suspend();
+    // lv_timer_handler returns right away from now on, this stops refresh and lv_anim as well
+    lv_timer_enable(false);
+
+    LOG_DBG("display suspended");
+}
+
+static void resume_work_cb(struct k_work *work) {
+    if (power != DONGLE_DISPLAY_POWER_OFF) {
+        return;
+    }
+
+    power = DONGLE_DISPLAY_POWER_ON;
+    suspended_ms += k_uptime_get() - suspended_at;
+
+    if (ambient_layout) {
+        leave_ambient();
+    }
+    arm_ambient();
+
+    lv_timer_enable(true);
+    // events recorded while blanked would only measure the idle time
+    dongle_latency_discard();
+    dongle_pacer_resume();
+    dongle_anim_resume();
+    // one full repaint instead of replaying what was missed
+    lv_obj_invalidate(lv_scr_act());
+
+    LOG_DBG("display resumed");
+}
+
+static K_WORK_DEFINE(suspend_work, suspend_work_cb);
+static K_WORK_DEFINE(resume_work, resume_work_cb);
+
+static int display_power_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+
+    if (ev == NULL || !zmk_display_is_initialized()) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // ZMK blanks the screen on anything but active
+    k_work_submit_to_queue(zmk_display_work_q(),
+                           ev->state == ZMK_ACTIVITY_ACTIVE ? &resume_work : &suspend_work);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_display_power, display_power_listener);
+ZMK_SUBSCRIPTION(dongle_display_power, zmk_activity_state_changed);
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SUSPEND_ON_BLANK) */
+
+enum dongle_display_power dongle_display_power_get(void) { return power; }
+
+void dongle_display_power_log_stats(void) {
+    LOG_INF("power: %u suspends, %u s suspended, %u ambient entries", suspends,
+            (uint32_t)(suspended_ms / 1000), ambient_entries);
+}
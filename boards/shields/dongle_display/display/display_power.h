@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// Display power states of the dongle screen.
+//
+// ON: full status screen, paced updates.
+// AMBIENT: after CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_TIMEOUT without key presses only battery and
+// layer stay on screen, LVGL timers are halted and changes are repainted at most once per
+// CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT_REFRESH seconds with reduced contrast and multiplex.
+// OFF: the screen is blanked by ZMK. LVGL timers and animations, the paced widget updates and the
+// widget deadlines are all halted; widget listeners keep recording the latest state (the shadow
+// model). On wake that state is applied in one batch and the screen is repainted once.
+
+enum dongle_display_power {
+    DONGLE_DISPLAY_POWER_ON,
+    DONGLE_DISPLAY_POWER_AMBIENT,
+    DONGLE_DISPLAY_POWER_OFF,
+};
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SUSPEND_ON_BLANK) ||                                     \
+    IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT)
+
+// Called once the status screen exists, on the display work queue.
+void dongle_display_power_init(void);
+
+enum dongle_display_power dongle_display_power_get(void);
+void dongle_display_power_log_stats(void);
+
+#else
+
+static inline void dongle_display_power_init(void) {}
+
+static inline enum dongle_display_power dongle_display_power_get(void) {
+    return DONGLE_DISPLAY_POWER_ON;
+}
+
+#endif
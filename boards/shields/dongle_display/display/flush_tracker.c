@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "async_flush.h"
+#include "flush_tracker.h"
+#include "latency.h"
+#include "stats.h"
+
+// SSD1306 GDDRAM is split into pages of 8 rows, one byte per column and page
+#define PAGE_HEIGHT 8
+
+// control byte, addressing mode (2), column window (3), page window (3) and the data control byte
+#define WINDOW_OVERHEAD_BYTES 10
+
+struct flush_region {
+    const char *name;
+    // the widget rectangle, NULL while the widget is not on the screen
+    const struct dongle_widget_rect *rect;
+    // union of the page-aligned windows that touched this region in the current frame
+    lv_area_t dirty;
+    bool is_dirty;
+    uint32_t bytes;
+};
+
+static struct flush_region regions[DONGLE_REGION_COUNT];
+static struct dongle_flush_stats stats;
+static uint32_t frame_bytes;
+static uint32_t screen_bytes;
+
+// With the async flush the last window is still on the bus when the flush callback returns, the
+// frame is closed once the transfer completion reports it sent
+static bool deferred;
+static bool frame_open;
+// k_uptime_get_32 of the completion, written from the interrupt
+static atomic_t frame_sent_at;
+
+static void (*next_flush_cb)(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+static void (*next_rounder_cb)(lv_disp_drv_t *drv, lv_area_t *area);
+
+static inline void snap_to_pages(lv_area_t *area) {
+    area->y1 &= ~(PAGE_HEIGHT - 1);
+    area->y2 |= PAGE_HEIGHT - 1;
+}
+
+static inline uint32_t window_bytes(const lv_area_t *area) {
+    return lv_area_get_width(area) * (lv_area_get_height(area) / PAGE_HEIGHT);
+}
+
+static void page_rounder_cb(lv_disp_drv_t *drv, lv_area_t *area) {
+    if (next_rounder_cb != NULL) {
+        next_rounder_cb(drv, area);
+    }
+
+    // keep the column window as tight as LVGL made it, only widen vertically to whole pages
+    snap_to_pages(area);
+}
+
+static void attribute_window(const lv_area_t *area) {
+    for (int i = 0; i < DONGLE_REGION_COUNT; i++) {
+        struct flush_region *region = &regions[i];
+        lv_area_t coords, overlap;
+
+        if (region->rect == NULL) {
+            continue;
+        }
+
+        lv_area_set(&coords, region->rect->x, region->rect->y,
+                    region->rect->x + region->rect->width - 1,
+                    region->rect->y + region->rect->height - 1);
+        if (!_lv_area_intersect(&overlap, area, &coords)) {
+            continue;
+        }
+
+        snap_to_pages(&overlap);
+        region->bytes += window_bytes(&overlap);
+
+        if (region->is_dirty) {
+            _lv_area_join(&region->dirty, &region->dirty, &overlap);
+        } else {
+            region->dirty = overlap;
+            region->is_dirty = true;
+        }
+    }
+}
+
+static void finish_frame(int64_t sent_at) {
+    uint32_t dirty_regions = 0;
+
+    stats.frames++;
+    stats.last_frame_bytes = frame_bytes;
+    stats.peak_frame_bytes = MAX(stats.peak_frame_bytes, frame_bytes);
+    stats.total_bytes += frame_bytes;
+    stats.full_frame_bytes += screen_bytes;
+
+    for (int i = 0; i < DONGLE_REGION_COUNT; i++) {
+        struct flush_region *region = &regions[i];
+
+        if (!region->is_dirty) {
+            continue;
+        }
+
+        LOG_DBG("flush %s: columns %d-%d, pages %d-%d", region->name, region->dirty.x1,
+                region->dirty.x2, region->dirty.y1 / PAGE_HEIGHT, region->dirty.y2 / PAGE_HEIGHT);
+        region->is_dirty = false;
+        dirty_regions |= BIT(i);
+    }
+
+    dongle_latency_frame_done(dirty_regions, sent_at);
+
+    LOG_DBG("frame %u: %u bytes", stats.frames, frame_bytes);
+    frame_bytes = 0;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_STATS)
+    dongle_stats_tick();
+#endif
+}
+
+static void close_frame(void) {
+    if (!frame_open) {
+        return;
+    }
+
+    // widen the 32 bit completion time, it lies at most a few seconds back
+    int64_t now = k_uptime_get();
+    uint32_t ago = (uint32_t)now - (uint32_t)atomic_get(&frame_sent_at);
+
+    frame_open = false;
+    finish_frame(now - ago);
+}
+
+static void frame_sent_work_cb(struct k_work *work) { close_frame(); }
+
+static K_WORK_DEFINE(frame_sent_work, frame_sent_work_cb);
+
+static void frame_sent(void) {
+    atomic_set(&frame_sent_at, k_uptime_get_32());
+    k_work_submit_to_queue(zmk_display_work_q(), &frame_sent_work);
+}
+
+static void tracked_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    bool last = lv_disp_flush_is_last(drv);
+
+    // LVGL waited for the previous transfer, close its frame if the work item did not run yet
+    close_frame();
+
+    frame_bytes += window_bytes(area) + WINDOW_OVERHEAD_BYTES;
+    stats.areas++;
+    attribute_window(area);
+
+    if (last && deferred) {
+        frame_open = true;
+        next_flush_cb(drv, area, color_p);
+        return;
+    }
+
+    // the synchronous driver returns once the window is written
+    next_flush_cb(drv, area, color_p);
+
+    if (last) {
+        finish_frame(k_uptime_get());
+    }
+}
+
+int dongle_flush_tracker_init(lv_disp_t *disp) {
+    if (disp == NULL || disp->driver == NULL || disp->driver->flush_cb == NULL) {
+        return -ENODEV;
+    }
+
+    if (disp->driver->flush_cb == tracked_flush_cb) {
+        return 0;
+    }
+
+    next_flush_cb = disp->driver->flush_cb;
+    next_rounder_cb = disp->driver->rounder_cb;
+
+    disp->driver->flush_cb = tracked_flush_cb;
+    disp->driver->rounder_cb = page_rounder_cb;
+
+    deferred = dongle_async_flush_on_frame_sent(frame_sent) == 0;
+
+    screen_bytes = disp->driver->hor_res * (disp->driver->ver_res / PAGE_HEIGHT) +
+                   WINDOW_OVERHEAD_BYTES;
+
+    return 0;
+}
+
+void dongle_flush_track(enum dongle_region region, const char *name,
+                        const struct dongle_widget_rect *rect) {
+    if (region >= DONGLE_REGION_COUNT) {
+        return;
+    }
+
+    regions[region].name = name;
+    regions[region].rect = rect;
+}
+
+void dongle_flush_get_stats(struct dongle_flush_stats *out) { *out = stats; }
+
+uint32_t dongle_flush_region_bytes(enum dongle_region region) {
+    return region < DONGLE_REGION_COUNT ? regions[region].bytes : 0;
+}
+
+const char *dongle_flush_region_name(enum dongle_region region) {
+    if (region >= DONGLE_REGION_COUNT || regions[region].name == NULL) {
+        return "?";
+    }
+
+    return regions[region].name;
+}
+
+void dongle_flush_log_stats(void) {
+    uint32_t saved_pct = 0;
+
+    if (stats.full_frame_bytes > 0) {
+        saved_pct = 100 - (uint32_t)((stats.total_bytes * 100) / stats.full_frame_bytes);
+    }
+
+    // kept to 32-bit conversions, the dongle is built with the nano cbprintf
+    LOG_INF("flush: %u frames, %u areas, last %u B, peak %u B, total %u KiB (%u%% saved)",
+            stats.frames, stats.areas, stats.last_frame_bytes, stats.peak_frame_bytes,
+            (uint32_t)(stats.total_bytes / 1024), saved_pct);
+
+    for (int i = 0; i < DONGLE_REGION_COUNT; i++) {
+        if (regions[i].rect != NULL) {
+            LOG_INF("flush: %s %u B", regions[i].name, regions[i].bytes);
+        }
+    }
+}
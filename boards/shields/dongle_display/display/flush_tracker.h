@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#include "widget.h"
+
+struct dongle_flush_stats {
+    uint32_t frames;
+    uint32_t areas;
+    uint32_t last_frame_bytes;
+    uint32_t peak_frame_bytes;
+    uint64_t total_bytes;
+    // what the same number of frames would have cost as full-screen flushes
+    uint64_t full_frame_bytes;
+};
+
+// Hooks the rounder and flush callbacks of the display driver so that invalidated areas are
+// snapped to SSD1306 pages and every flushed window is accounted for. A frame is closed once its
+// last window has been sent, with the async flush that is its transfer completion. Must run after
+// dongle_async_flush_init.
+int dongle_flush_tracker_init(lv_disp_t *disp);
+
+// Attributes flushed bytes that overlap rect to the given region, NULL stops tracking it.
+void dongle_flush_track(enum dongle_region region, const char *name,
+                        const struct dongle_widget_rect *rect);
+
+void dongle_flush_get_stats(struct dongle_flush_stats *stats);
+uint32_t dongle_flush_region_bytes(enum dongle_region region);
+const char *dongle_flush_region_name(enum dongle_region region);
+void dongle_flush_log_stats(void);
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <lvgl.h>
+
+#include "heap.h"
+#include "widget.h"
+
+// The originals from modules/lvgl/lvgl_mem.c, the linker routes every LVGL call to the wrappers
+void *__real_lvgl_malloc(size_t size);
+void *__real_lvgl_realloc(void *ptr, size_t size);
+void __real_lvgl_free(void *ptr);
+
+// sys_heap hands out 8 byte units behind a chunk header, an upper bound of what a block costs
+#define CHUNK_BYTES(size) ROUND_UP((size) + 8, 8)
+
+static const struct dongle_widget *scope_widget;
+static enum dongle_heap_scope scope;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+// In front of every block so that frees find the owner and size again
+struct block_header {
+    struct dongle_heap_usage *owner;
+    uint32_t size;
+};
+
+#define HEADER_SIZE ROUND_UP(sizeof(struct block_header), 8)
+
+static struct dongle_heap_stats stats;
+static uint32_t scope_objects;
+#else
+#define HEADER_SIZE 0
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+static uint8_t __aligned(8) arena_mem[CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA_SIZE];
+static struct sys_heap arena;
+static bool arena_ready;
+static uint32_t arena_fallbacks;
+
+static bool in_arena(const void *ptr) {
+    const uint8_t *byte = ptr;
+
+    return byte >= arena_mem && byte < arena_mem + sizeof(arena_mem);
+}
+
+static void *arena_alloc(size_t size) {
+    if (!arena_ready) {
+        sys_heap_init(&arena, arena_mem, sizeof(arena_mem));
+        arena_ready = true;
+    }
+
+    void *ptr = sys_heap_alloc(&arena, size);
+    if (ptr == NULL && arena_fallbacks++ == 0) {
+        LOG_WRN("Widget arena full, raise CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA_SIZE");
+    }
+
+    return ptr;
+}
+#else
+static inline bool in_arena(const void *ptr) { return false; }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+static struct dongle_heap_usage *current_owner(void) {
+    return scope_widget != NULL ? &scope_widget->state->heap : &stats.lvgl;
+}
+
+static void account(bool arena, int32_t delta) {
+    if (arena) {
+        stats.arena_live += delta;
+        stats.arena_peak = MAX(stats.arena_peak, stats.arena_live);
+    } else {
+        stats.pool_live += delta;
+        stats.pool_peak = MAX(stats.pool_peak, stats.pool_live);
+    }
+}
+
+static void charge(struct dongle_heap_usage *owner, int32_t delta) {
+    owner->live_bytes += delta;
+    owner->peak_bytes = MAX(owner->peak_bytes, owner->live_bytes);
+}
+
+static uint32_t count_tree(lv_obj_t *obj) {
+    uint32_t count = 1;
+
+    for (uint32_t i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        count += count_tree(lv_obj_get_child(obj, i));
+    }
+
+    return count;
+}
+
+static uint32_t count_objects(void) {
+    lv_disp_t *disp = lv_disp_get_default();
+    uint32_t count = 0;
+
+    if (disp == NULL) {
+        return 0;
+    }
+
+    // the top and system layers are screens as well
+    for (uint32_t i = 0; i < disp->screen_cnt; i++) {
+        count += count_tree(disp->screens[i]);
+    }
+
+    return count;
+}
+#else
+static inline void account(bool arena, int32_t delta) {}
+#endif
+
+// Blocks of a build scope go to the arena while it has room, everything else to the pool
+static void *block_alloc(size_t size) {
+    void *block = NULL;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+    if (scope_widget != NULL && scope == DONGLE_HEAP_BUILD) {
+        block = arena_alloc(size);
+    }
+#endif
+
+    if (block == NULL) {
+        block = __real_lvgl_malloc(size);
+    }
+
+    if (block != NULL) {
+        account(in_arena(block), CHUNK_BYTES(size));
+    }
+
+    return block;
+}
+
+static void block_free(void *block, size_t size) {
+    account(in_arena(block), -(int32_t)CHUNK_BYTES(size));
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+    if (in_arena(block)) {
+        sys_heap_free(&arena, block);
+        return;
+    }
+#endif
+
+    __real_lvgl_free(block);
+}
+
+static void *block_realloc(void *block, size_t old_size, size_t size) {
+    void *moved;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+    if (in_arena(block)) {
+        moved = sys_heap_realloc(&arena, block, size);
+        if (moved == NULL) {
+            // no room to grow in the arena, the block continues in the pool
+            moved = __real_lvgl_malloc(size);
+            if (moved == NULL) {
+                return NULL;
+            }
+
+            memcpy(moved, block, MIN(sys_heap_usable_size(&arena, block), size));
+            sys_heap_free(&arena, block);
+        }
+
+        account(true, -(int32_t)CHUNK_BYTES(old_size));
+        account(in_arena(moved), CHUNK_BYTES(size));
+        return moved;
+    }
+#endif
+
+    moved = __real_lvgl_realloc(block, size);
+    if (moved != NULL) {
+        account(false, (int32_t)CHUNK_BYTES(size) - (int32_t)CHUNK_BYTES(old_size));
+    }
+
+    return moved;
+}
+
+void *__wrap_lvgl_malloc(size_t size) {
+    uint8_t *block = block_alloc(size + HEADER_SIZE);
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    if (block == NULL) {
+        stats.failed++;
+        return NULL;
+    }
+
+    struct block_header *header = (struct block_header *)block;
+
+    header->owner = current_owner();
+    header->size = size;
+    charge(header->owner, size);
+    header->owner->blocks++;
+    header->owner->allocs++;
+#endif
+
+    return block != NULL ? block + HEADER_SIZE : NULL;
+}
+
+void __wrap_lvgl_free(void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    uint8_t *block = (uint8_t *)ptr - HEADER_SIZE;
+    size_t size = 0;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    struct block_header *header = (struct block_header *)block;
+
+    size = header->size + HEADER_SIZE;
+    charge(header->owner, -(int32_t)header->size);
+    header->owner->blocks--;
+#endif
+
+    block_free(block, size);
+}
+
+void *__wrap_lvgl_realloc(void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return __wrap_lvgl_malloc(size);
+    }
+
+    if (size == 0) {
+        __wrap_lvgl_free(ptr);
+        return NULL;
+    }
+
+    uint8_t *block = (uint8_t *)ptr - HEADER_SIZE;
+    size_t old_size = 0;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    old_size = ((struct block_header *)block)->size + HEADER_SIZE;
+#endif
+
+    block = block_realloc(block, old_size, size + HEADER_SIZE);
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    if (block == NULL) {
+        stats.failed++;
+        return NULL;
+    }
+
+    // the block stays with the owner that allocated it
+    struct block_header *header = (struct block_header *)block;
+
+    charge(header->owner, (int32_t)size - (int32_t)header->size);
+    header->size = size;
+#endif
+
+    return block != NULL ? block + HEADER_SIZE : NULL;
+}
+
+void dongle_heap_enter(const struct dongle_widget *widget, enum dongle_heap_scope new_scope) {
+    __ASSERT(scope_widget == NULL, "heap scopes do not nest");
+
+    scope_widget = widget;
+    scope = new_scope;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    if (scope == DONGLE_HEAP_BUILD) {
+        scope_objects = count_objects();
+    }
+#endif
+}
+
+void dongle_heap_leave(void) {
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    if (scope_widget != NULL && scope == DONGLE_HEAP_BUILD) {
+        scope_widget->state->heap.objects += (int32_t)count_objects() - (int32_t)scope_objects;
+    }
+#endif
+
+    scope_widget = NULL;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+
+static uint32_t largest_free_block(void) {
+    uint32_t low = 0;
+    uint32_t high = CONFIG_LV_Z_MEM_POOL_SIZE;
+
+    // straight to the pool, probes are neither accounted nor failures
+    while (low < high) {
+        uint32_t size = (low + high + 1) / 2;
+        void *probe = __real_lvgl_malloc(size);
+
+        if (probe != NULL) {
+            __real_lvgl_free(probe);
+            low = size;
+        } else {
+            high = size - 1;
+        }
+    }
+
+    return low;
+}
+
+void dongle_heap_get_stats(struct dongle_heap_stats *out) {
+    *out = stats;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+    out->arena_fallbacks = arena_fallbacks;
+#endif
+
+    uint32_t used = MIN(out->pool_live, CONFIG_LV_Z_MEM_POOL_SIZE);
+    uint32_t free_bytes = CONFIG_LV_Z_MEM_POOL_SIZE - used;
+
+    out->pool_largest_free = largest_free_block();
+    out->fragmentation_pct =
+        free_bytes > out->pool_largest_free ? 100 - (out->pool_largest_free * 100) / free_bytes : 0;
+    out->objects = count_objects();
+}
+
+static void log_usage(const char *name, const struct dongle_heap_usage *usage) {
+    LOG_INF("heap: %s %u B live, %u B peak, %u blocks, %u allocs, %d objects", name,
+            usage->live_bytes, usage->peak_bytes, usage->blocks, usage->allocs, usage->objects);
+}
+
+void dongle_heap_log_stats(void) {
+    struct dongle_heap_stats s;
+
+    dongle_heap_get_stats(&s);
+
+    LOG_INF("heap: pool %u of %u B, peak %u B, largest free %u B (%u%% fragmented), %u failed",
+            s.pool_live, CONFIG_LV_Z_MEM_POOL_SIZE, s.pool_peak, s.pool_largest_free,
+            s.fragmentation_pct, s.failed);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+    LOG_INF("heap: arena %u of %u B, peak %u B, %u fallbacks", s.arena_live,
+            CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA_SIZE, s.arena_peak, s.arena_fallbacks);
+#endif
+    LOG_INF("heap: %u lv_obj", s.objects);
+
+    STRUCT_SECTION_FOREACH(dongle_widget, widget) {
+        log_usage(widget->name, &widget->state->heap);
+    }
+    log_usage("lvgl", &s.lvgl);
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS) */
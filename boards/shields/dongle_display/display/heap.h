@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// The Zephyr LVGL heap functions are wrapped at link time. With the heap stats every allocation
+// is charged to the widget that made it, with the widget arena the objects a widget creates come
+// from a fixed arena instead of the LVGL pool. Everything LVGL allocates outside a widget, such
+// as the screen, timers and the refresh, is charged to "lvgl".
+
+struct dongle_widget;
+
+enum dongle_heap_scope {
+    // the widget updates its objects
+    DONGLE_HEAP_RENDER,
+    // the widget creates or deletes its objects, these are counted and taken from the arena
+    DONGLE_HEAP_BUILD,
+};
+
+struct dongle_heap_usage {
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    // live allocations, many small ones fragment the pool
+    uint32_t blocks;
+    uint32_t allocs;
+    // live lv_obj created in build scopes
+    int32_t objects;
+};
+
+struct dongle_heap_stats {
+    // estimated pool bytes in use including the sys_heap chunk overhead, without the arena
+    uint32_t pool_live;
+    uint32_t pool_peak;
+    // largest block the pool can still hand out and how much of the free pool is not in it
+    uint32_t pool_largest_free;
+    uint32_t fragmentation_pct;
+    uint32_t arena_live;
+    uint32_t arena_peak;
+    // build allocations that did not fit in the arena and came from the pool
+    uint32_t arena_fallbacks;
+    uint32_t failed;
+    // lv_obj on every screen and layer of the display
+    uint32_t objects;
+    struct dongle_heap_usage lvgl;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS) ||                                           \
+    IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WIDGET_ARENA)
+// Charges allocations to widget until dongle_heap_leave. Scopes do not nest, call from the
+// display work queue.
+void dongle_heap_enter(const struct dongle_widget *widget, enum dongle_heap_scope scope);
+void dongle_heap_leave(void);
+#else
+static inline void dongle_heap_enter(const struct dongle_widget *widget,
+                                     enum dongle_heap_scope scope) {}
+static inline void dongle_heap_leave(void) {}
+#endif
+
+// Probes the pool for its largest free block, call from the display work queue.
+void dongle_heap_get_stats(struct dongle_heap_stats *stats);
+void dongle_heap_log_stats(void);
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/workqueue.h>
+
+#include "heatmap_store.h"
+
+BUILD_ASSERT(DONGLE_KEY_POSITION_COUNT > 0, "the key heatmap needs a matrix transform");
+
+static atomic_t counts[DONGLE_KEY_POSITION_COUNT];
+static atomic_t presses;
+static atomic_t unsaved;
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+
+static atomic_t saves;
+static atomic_t save_errors;
+
+// The save work and the save before sleep run on different threads, one at a time fills stored.
+// settings_load writes it as well, before anything is saved.
+static K_MUTEX_DEFINE(save_lock);
+static uint32_t stored[DONGLE_KEY_POSITION_COUNT];
+
+static void save(void) {
+    k_mutex_lock(&save_lock, K_FOREVER);
+
+    // read under the lock, a save that just finished has already taken its presses off
+    atomic_val_t pending = atomic_get(&unsaved);
+
+    if (pending == 0) {
+        k_mutex_unlock(&save_lock);
+        return;
+    }
+
+    dongle_heatmap_snapshot(stored);
+
+    int err = settings_save_one("dongle_display/heatmap", stored, sizeof(stored));
+    if (err) {
+        LOG_WRN("Failed to save the key heatmap (%d)", err);
+        atomic_inc(&save_errors);
+    } else {
+        // presses counted while the flash was busy stay unsaved for the next batch
+        atomic_sub(&unsaved, pending);
+        atomic_inc(&saves);
+    }
+
+    k_mutex_unlock(&save_lock);
+}
+
+static void save_work_handler(struct k_work *work) { save(); }
+
+static K_WORK_DEFINE(save_work, save_work_handler);
+
+static int heatmap_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                                void *cb_arg) {
+    if (!settings_name_steq(name, "heatmap", NULL)) {
+        return -ENOENT;
+    }
+
+    // a different transform makes the old positions meaningless
+    if (len != sizeof(stored)) {
+        LOG_WRN("Discarding a key heatmap saved for %u keys",
+                (uint32_t)(len / sizeof(stored[0])));
+        return 0;
+    }
+
+    int rc = read_cb(cb_arg, stored, sizeof(stored));
+    if (rc < 0) {
+        return rc;
+    }
+
+    // added rather than assigned, presses made before settings were loaded are kept
+    for (int i = 0; i < DONGLE_KEY_POSITION_COUNT; i++) {
+        atomic_add(&counts[i], stored[i]);
+    }
+
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(dongle_display, "dongle_display", NULL, heatmap_settings_set, NULL,
+                               NULL);
+
+static void activity_changed(const struct zmk_activity_state_changed *ev) {
+    switch (ev->state) {
+    case ZMK_ACTIVITY_IDLE:
+        if (atomic_get(&unsaved) >= CONFIG_ZMK_DONGLE_DISPLAY_HEATMAP_SAVE_BATCH) {
+            k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &save_work);
+        }
+        break;
+    case ZMK_ACTIVITY_SLEEP:
+        // the power off follows right after this event, there is no later chance
+        save();
+        break;
+    default:
+        break;
+    }
+}
+
+#endif /* IS_ENABLED(CONFIG_SETTINGS) */
+
+static int heatmap_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *pos = as_zmk_position_state_changed(eh);
+
+    if (pos != NULL) {
+        if (pos->state && pos->position < DONGLE_KEY_POSITION_COUNT) {
+            atomic_inc(&counts[pos->position]);
+            atomic_inc(&presses);
+            atomic_inc(&unsaved);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+    const struct zmk_activity_state_changed *activity = as_zmk_activity_state_changed(eh);
+    if (activity != NULL) {
+        activity_changed(activity);
+    }
+#endif
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_heatmap, heatmap_listener);
+ZMK_SUBSCRIPTION(dongle_heatmap, zmk_position_state_changed);
+#if IS_ENABLED(CONFIG_SETTINGS)
+ZMK_SUBSCRIPTION(dongle_heatmap, zmk_activity_state_changed);
+#endif
+
+uint32_t dongle_heatmap_snapshot(uint32_t *out) {
+    uint32_t max = 0;
+
+    for (int i = 0; i < DONGLE_KEY_POSITION_COUNT; i++) {
+        out[i] = (uint32_t)atomic_get(&counts[i]);
+        max = MAX(max, out[i]);
+    }
+
+    return max;
+}
+
+void dongle_heatmap_get_stats(struct dongle_heatmap_stats *stats) {
+    *stats = (struct dongle_heatmap_stats){
+        .presses = (uint32_t)atomic_get(&presses),
+        .unsaved = (uint32_t)atomic_get(&unsaved),
+#if IS_ENABLED(CONFIG_SETTINGS)
+        .saves = (uint32_t)atomic_get(&saves),
+        .save_errors = (uint32_t)atomic_get(&save_errors),
+#endif
+    };
+}
+
+void dongle_heatmap_log_stats(void) {
+    struct dongle_heatmap_stats stats;
+
+    dongle_heatmap_get_stats(&stats);
+    LOG_INF("heatmap: %u presses, %u unsaved, %u saves, %u failed", stats.presses, stats.unsaved,
+            stats.saves, stats.save_errors);
+}
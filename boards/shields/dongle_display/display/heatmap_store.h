@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include "key_position.h"
+
+// Press counts per keymap position, one counter per key of the matrix transform. A press costs
+// three atomic increments on the event path. The counts are written to the settings subsystem
+// from the low priority work queue, and only once CONFIG_ZMK_DONGLE_DISPLAY_HEATMAP_SAVE_BATCH
+// presses are unsaved and the keyboard has gone idle, or right before it goes to sleep.
+
+struct dongle_heatmap_stats {
+    // presses counted since boot, also usable as a change generation
+    uint32_t presses;
+    uint32_t unsaved;
+    uint32_t saves;
+    uint32_t save_errors;
+};
+
+// Copies the DONGLE_KEY_POSITION_COUNT counters to counts and returns the largest one.
+uint32_t dongle_heatmap_snapshot(uint32_t *counts);
+
+void dongle_heatmap_get_stats(struct dongle_heatmap_stats *stats);
+void dongle_heatmap_log_stats(void);
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <dt-bindings/zmk/matrix_transform.h>
+
+#include "key_position.h"
+
+#if defined(DONGLE_KEY_TRANSFORM_NODE)
+
+#define TRANSFORM_NODE DONGLE_KEY_TRANSFORM_NODE
+#define KEY_COUNT DONGLE_KEY_POSITION_COUNT
+
+#define MAP_ROW(idx) KT_ROW(DT_PROP_BY_IDX(TRANSFORM_NODE, map, idx))
+#define MAP_COL(idx) KT_COL(DT_PROP_BY_IDX(TRANSFORM_NODE, map, idx))
+
+// A key is on the right half when its centre lies right of the mean centre of all keys, which
+// is the mirror axis of a symmetric split. Centres are doubled to stay in integers.
+#if defined(DONGLE_KEY_LAYOUT_NODE) && DT_NODE_HAS_PROP(DONGLE_KEY_LAYOUT_NODE, keys)
+
+#define LAYOUT_NODE DONGLE_KEY_LAYOUT_NODE
+
+BUILD_ASSERT(DT_PROP_LEN(LAYOUT_NODE, keys) == KEY_COUNT,
+             "physical layout and matrix transform disagree on the number of keys");
+
+// physical positions are in hundredths of a key unit
+#define KEY_CENTER(node_id, prop, idx)                                                             \
+    (2 * DT_PHA_BY_IDX(node_id, prop, idx, x) + DT_PHA_BY_IDX(node_id, prop, idx, width))
+#define CENTER_SUM (DT_FOREACH_PROP_ELEM_SEP(LAYOUT_NODE, keys, KEY_CENTER, (+)))
+#define CENTER(idx) KEY_CENTER(LAYOUT_NODE, keys, idx)
+
+#else
+
+// without physical attributes the matrix column is the best horizontal position there is
+#define MAP_CENTER(node_id, prop, idx) (2 * KT_COL(DT_PROP_BY_IDX(node_id, prop, idx)) + 1)
+#define CENTER_SUM (DT_FOREACH_PROP_ELEM_SEP(TRANSFORM_NODE, map, MAP_CENTER, (+)))
+#define CENTER(idx) MAP_CENTER(TRANSFORM_NODE, map, idx)
+
+#endif
+
+// folded once here, the foreach macro cannot expand again inside the table below
+enum { CENTER_TOTAL = CENTER_SUM };
+
+#define KEY_SIDE(idx)                                                                              \
+    ((int64_t)CENTER(idx) * KEY_COUNT > (int64_t)CENTER_TOTAL ? DONGLE_KEY_SIDE_RIGHT             \
+                                                               : DONGLE_KEY_SIDE_LEFT)
+
+#define KEY_ENTRY(node_id, prop, idx)                                                              \
+    {.row = MAP_ROW(idx), .col = MAP_COL(idx), .side = KEY_SIDE(idx)}
+
+static const struct dongle_key_position positions[] = {
+    DT_FOREACH_PROP_ELEM_SEP(TRANSFORM_NODE, map, KEY_ENTRY, (, ))};
+
+const struct dongle_key_position *dongle_key_position_get(uint32_t position) {
+    return position < KEY_COUNT ? &positions[position] : NULL;
+}
+
+#else
+
+const struct dongle_key_position *dongle_key_position_get(uint32_t position) { return NULL; }
+
+#endif
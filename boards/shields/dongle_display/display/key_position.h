@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+
+// Where a keymap position sits on the keyboard, generated at build time from the matrix
+// transform of the chosen physical layout (or the chosen zmk,matrix-transform).
+
+#if DT_HAS_CHOSEN(zmk_physical_layout)
+#define DONGLE_KEY_LAYOUT_NODE DT_CHOSEN(zmk_physical_layout)
+#define DONGLE_KEY_TRANSFORM_NODE DT_PHANDLE(DONGLE_KEY_LAYOUT_NODE, transform)
+#elif DT_HAS_CHOSEN(zmk_matrix_transform)
+#define DONGLE_KEY_TRANSFORM_NODE DT_CHOSEN(zmk_matrix_transform)
+#endif
+
+#if defined(DONGLE_KEY_TRANSFORM_NODE)
+#define DONGLE_KEY_POSITION_COUNT DT_PROP_LEN(DONGLE_KEY_TRANSFORM_NODE, map)
+#define DONGLE_KEY_MATRIX_ROWS DT_PROP(DONGLE_KEY_TRANSFORM_NODE, rows)
+#define DONGLE_KEY_MATRIX_COLUMNS DT_PROP(DONGLE_KEY_TRANSFORM_NODE, columns)
+#else
+#define DONGLE_KEY_POSITION_COUNT 0
+#define DONGLE_KEY_MATRIX_ROWS 0
+#define DONGLE_KEY_MATRIX_COLUMNS 0
+#endif
+
+enum dongle_key_side {
+    DONGLE_KEY_SIDE_LEFT,
+    DONGLE_KEY_SIDE_RIGHT,
+};
+
+struct dongle_key_position {
+    uint8_t row;
+    uint8_t col;
+    uint8_t side;
+};
+
+// O(1) lookup of a keymap position, NULL for positions outside the transform.
+const struct dongle_key_position *dongle_key_position_get(uint32_t position);
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <lvgl.h>
+
+#include "latency.h"
+
+struct latency_slot {
+    // oldest event not yet on the glass
+    int64_t pending_since;
+    bool pending;
+    bool applied;
+    struct dongle_latency_histogram histogram;
+};
+
+static struct latency_slot slots[DONGLE_REGION_COUNT];
+static struct k_spinlock lock;
+
+static void record(struct dongle_latency_histogram *histogram, uint32_t latency_ms) {
+    int bucket = 0;
+
+    while (bucket < DONGLE_LATENCY_BUCKETS - 1 && latency_ms >= BIT(bucket)) {
+        bucket++;
+    }
+
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total_ms += latency_ms;
+    histogram->max_ms = MAX(histogram->max_ms, latency_ms);
+}
+
+void dongle_latency_mark(enum dongle_region region, int64_t timestamp) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    struct latency_slot *slot = &slots[region];
+
+    // during a burst keep the oldest unapplied event, that is the lag the user sees
+    if (!slot->pending) {
+        slot->pending_since = timestamp;
+        slot->pending = true;
+        slot->applied = false;
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_latency_applied(enum dongle_region region) {
+    lv_disp_t *disp = lv_disp_get_default();
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    struct latency_slot *slot = &slots[region];
+
+    if (slot->pending) {
+        // an update that invalidated nothing will never reach the controller
+        if (disp != NULL && disp->inv_p == 0) {
+            slot->pending = false;
+        } else {
+            slot->applied = true;
+        }
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_latency_frame_done(uint32_t dirty_regions, int64_t sent_at) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    for (int i = 0; i < DONGLE_REGION_COUNT; i++) {
+        struct latency_slot *slot = &slots[i];
+
+        if (!slot->pending || !slot->applied) {
+            continue;
+        }
+
+        if (dirty_regions & BIT(i)) {
+            record(&slot->histogram, (uint32_t)MAX(sent_at - slot->pending_since, 0));
+        }
+
+        slot->pending = false;
+        slot->applied = false;
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_latency_discard(void) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    for (int i = 0; i < DONGLE_REGION_COUNT; i++) {
+        slots[i].pending = false;
+        slots[i].applied = false;
+    }
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_latency_get(enum dongle_region region, struct dongle_latency_histogram *histogram) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    *histogram = slots[region].histogram;
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_latency_log_stats(void) {
+    for (int i = 0; i < DONGLE_REGION_COUNT; i++) {
+        const char *name = dongle_flush_region_name(i);
+        struct dongle_latency_histogram h;
+
+        dongle_latency_get(i, &h);
+        if (h.count == 0) {
+            continue;
+        }
+
+        LOG_INF("latency %s: n %u avg %u max %u ms", name, h.count,
+                (uint32_t)(h.total_ms / h.count), h.max_ms);
+        LOG_INF("latency %s: <1 %u <2 %u <4 %u <8 %u <16 %u <32 %u <64 %u <128 %u <256 %u "
+                "<512 %u more %u",
+                name, h.buckets[0], h.buckets[1], h.buckets[2], h.buckets[3], h.buckets[4],
+                h.buckets[5], h.buckets[6], h.buckets[7], h.buckets[8], h.buckets[9], h.buckets[10]);
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include "flush_tracker.h"
+
+// Event-to-pixel latency: a widget marks the uptime of the originating ZMK event in its listener,
+// reports when its update callback has applied the state, and the flush tracker closes the
+// measurement once a frame touching the widget has been sent to the controller.
+
+#define DONGLE_LATENCY_BUCKETS 11 // <1, <2, <4 ... <512, >=512 ms
+
+struct dongle_latency_histogram {
+    uint32_t buckets[DONGLE_LATENCY_BUCKETS];
+    uint32_t count;
+    uint32_t max_ms;
+    uint64_t total_ms;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LATENCY)
+
+void dongle_latency_mark(enum dongle_region region, int64_t timestamp);
+void dongle_latency_applied(enum dongle_region region);
+// sent_at is the uptime the last window of the frame reached the controller
+void dongle_latency_frame_done(uint32_t dirty_regions, int64_t sent_at);
+void dongle_latency_discard(void);
+void dongle_latency_get(enum dongle_region region, struct dongle_latency_histogram *histogram);
+void dongle_latency_log_stats(void);
+
+#else
+
+static inline void dongle_latency_mark(enum dongle_region region, int64_t timestamp) {}
+static inline void dongle_latency_applied(enum dongle_region region) {}
+static inline void dongle_latency_frame_done(uint32_t dirty_regions, int64_t sent_at) {}
+static inline void dongle_latency_discard(void) {}
+
+#endif
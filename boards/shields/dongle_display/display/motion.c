@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "motion.h"
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_REDUCED_MOTION)
+#include "events/typing_rate_changed.h"
+#endif
+
+static struct dongle_motion_stats stats;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_REDUCED_MOTION)
+
+bool dongle_motion_reduced(void) {
+    struct dongle_typing_rate rate;
+
+    // the typing rate engine keeps the 1 s window current while keys are pressed, 5 keys a word
+    // over 1/60 minute make 12 WPM per press in the window
+    dongle_typing_rate_get(&rate);
+    return rate.wpm[DONGLE_TYPING_WINDOW_1S] >= CONFIG_ZMK_DONGLE_DISPLAY_REDUCED_MOTION_RATE * 12;
+}
+
+#else
+
+bool dongle_motion_reduced(void) { return false; }
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_REDUCED_MOTION) */
+
+void dongle_motion_animate(lv_obj_t *obj, lv_anim_exec_xcb_t exec_cb, lv_anim_path_cb_t path_cb,
+                           uint32_t time, int32_t from, int32_t to) {
+    lv_anim_t *running = lv_anim_get(obj, exec_cb);
+
+    if (dongle_motion_reduced()) {
+        if (running != NULL) {
+            lv_anim_del(obj, exec_cb);
+        }
+        exec_cb(obj, to);
+        stats.skipped++;
+        return;
+    }
+
+    if (running != NULL) {
+        if (running->end_value == to) {
+            stats.skipped++;
+            return;
+        }
+
+        // the same lv_anim_t continues from where the property is now, no allocation
+        running->start_value = running->current_value;
+        running->end_value = to;
+        running->act_time = 0;
+        stats.retargeted++;
+        return;
+    }
+
+    if (from == to) {
+        stats.skipped++;
+        return;
+    }
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, obj);
+    lv_anim_set_time(&a, time);
+    lv_anim_set_exec_cb(&a, exec_cb);
+    lv_anim_set_path_cb(&a, path_cb);
+    lv_anim_set_values(&a, from, to);
+    lv_anim_start(&a);
+    stats.started++;
+}
+
+void dongle_motion_get_stats(struct dongle_motion_stats *out) { *out = stats; }
+
+void dongle_motion_log_stats(void) {
+    LOG_INF("motion: %u started, %u retargeted, %u skipped%s", stats.started, stats.retargeted,
+            stats.skipped, dongle_motion_reduced() ? ", reduced" : "");
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+// Widget animations keyed by object and exec callback. A new target for a running animation
+// retargets it from its current value instead of starting a second one on the same object, so a
+// burst of toggles keeps at most one animation per property alive. While the 1 s window of the
+// typing rate holds CONFIG_ZMK_DONGLE_DISPLAY_REDUCED_MOTION_RATE presses every change snaps.
+
+struct dongle_motion_stats {
+    uint32_t started;
+    uint32_t retargeted;
+    // snapped in reduced motion or already heading for the target
+    uint32_t skipped;
+};
+
+// Animates exec_cb of obj to the value to over time ms. from is only used when no animation of
+// the same object and callback is running. Call from the display work queue.
+void dongle_motion_animate(lv_obj_t *obj, lv_anim_exec_xcb_t exec_cb, lv_anim_path_cb_t path_cb,
+                           uint32_t time, int32_t from, int32_t to);
+
+bool dongle_motion_reduced(void);
+
+void dongle_motion_get_stats(struct dongle_motion_stats *stats);
+void dongle_motion_log_stats(void);
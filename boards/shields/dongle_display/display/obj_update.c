@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "obj_update.h"
+
+// only touched from the display work queue, like every other LVGL call
+static struct dongle_obj_update_stats stats;
+
+static inline bool count(bool changed) {
+    if (changed) {
+        stats.applied++;
+    } else {
+        stats.suppressed++;
+    }
+
+    return changed;
+}
+
+bool dongle_img_set_src(lv_obj_t *img, const void *src) {
+    if (!count(lv_img_get_src(img) != src)) {
+        return false;
+    }
+
+    lv_img_set_src(img, src);
+    return true;
+}
+
+bool dongle_label_set_text_static(lv_obj_t *label, const char *text) {
+    if (!count(lv_label_get_text(label) != text)) {
+        return false;
+    }
+
+    lv_label_set_text_static(label, text);
+    return true;
+}
+
+bool dongle_obj_set_hidden(lv_obj_t *obj, bool hidden) {
+    if (!count(lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN) != hidden)) {
+        return false;
+    }
+
+    if (hidden) {
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    }
+    return true;
+}
+
+void dongle_obj_update_get_stats(struct dongle_obj_update_stats *out) { *out = stats; }
+
+void dongle_obj_update_log_stats(void) {
+    LOG_INF("obj: %u updates applied, %u redundant updates suppressed", stats.applied,
+            stats.suppressed);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+// Setters for widget objects that skip the LVGL call, and with it the invalidation and redraw,
+// when the object already shows the requested value. They return true if LVGL was called.
+
+bool dongle_img_set_src(lv_obj_t *img, const void *src);
+
+// text must have static lifetime, it is compared by pointer against the current label text
+bool dongle_label_set_text_static(lv_obj_t *label, const char *text);
+
+bool dongle_obj_set_hidden(lv_obj_t *obj, bool hidden);
+
+struct dongle_obj_update_stats {
+    uint32_t applied;
+    uint32_t suppressed;
+};
+
+void dongle_obj_update_get_stats(struct dongle_obj_update_stats *stats);
+void dongle_obj_update_log_stats(void);
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "pacer.h"
+
+static sys_slist_t pending = SYS_SLIST_STATIC_INIT(&pending);
+static struct dongle_pacer_stats stats;
+static int64_t last_frame;
+static bool suspended;
+static uint32_t period_ms = CONFIG_ZMK_DONGLE_DISPLAY_FRAME_PERIOD;
+static void (*after_frame)(void);
+static struct k_spinlock lock;
+
+static void frame_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(frame_work, frame_work_cb);
+
+void dongle_pacer_request(struct dongle_pacer_widget *widget) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (suspended) {
+        stats.shadowed++;
+    }
+
+    if (widget->pending) {
+        stats.dropped++;
+        k_spin_unlock(&lock, key);
+        return;
+    }
+
+    widget->pending = true;
+    sys_slist_append(&pending, &widget->node);
+
+    if (suspended) {
+        k_spin_unlock(&lock, key);
+        return;
+    }
+
+    // never render more often than the frame period, but do not delay the first event of a burst
+    int64_t due = last_frame + period_ms;
+    int64_t now = k_uptime_get();
+
+    k_spin_unlock(&lock, key);
+
+    // does nothing while a frame is already armed, that frame picks this widget up as well
+    k_work_schedule_for_queue(zmk_display_work_q(), &frame_work,
+                              due > now ? K_MSEC(due - now) : K_NO_WAIT);
+}
+
+void dongle_pacer_flush(void) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    sys_slist_t batch = pending;
+    uint32_t count = 0;
+
+    sys_slist_init(&pending);
+    last_frame = k_uptime_get();
+
+    k_spin_unlock(&lock, key);
+
+    struct dongle_pacer_widget *widget, *next;
+    SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&batch, widget, next, node) {
+        // clear first so an event raised while applying arms the next frame
+        key = k_spin_lock(&lock);
+        widget->pending = false;
+        k_spin_unlock(&lock, key);
+
+        widget->apply();
+        count++;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    key = k_spin_lock(&lock);
+    stats.frames++;
+    stats.applied += count;
+    stats.merged += count - 1;
+    k_spin_unlock(&lock, key);
+
+    if (after_frame != NULL) {
+        after_frame();
+    }
+}
+
+static void frame_work_cb(struct k_work *work) { dongle_pacer_flush(); }
+
+void dongle_pacer_suspend(void) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    suspended = true;
+
+    k_spin_unlock(&lock, key);
+
+    k_work_cancel_delayable(&frame_work);
+}
+
+void dongle_pacer_resume(void) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    suspended = false;
+
+    k_spin_unlock(&lock, key);
+
+    dongle_pacer_flush();
+}
+
+void dongle_pacer_set_period(uint32_t period, void (*cb)(void)) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    uint32_t old_period = period_ms;
+
+    period_ms = period > 0 ? period : CONFIG_ZMK_DONGLE_DISPLAY_FRAME_PERIOD;
+    after_frame = cb;
+
+    // a frame armed under the longer period would hold back everything pending until then, and
+    // requests do not move an armed frame
+    bool rearm = period_ms < old_period && !suspended && !sys_slist_is_empty(&pending);
+    int64_t due = last_frame + period_ms;
+    int64_t now = k_uptime_get();
+
+    k_spin_unlock(&lock, key);
+
+    if (rearm) {
+        k_work_reschedule_for_queue(zmk_display_work_q(), &frame_work,
+                                    due > now ? K_MSEC(due - now) : K_NO_WAIT);
+    }
+}
+
+void dongle_pacer_get_stats(struct dongle_pacer_stats *out) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    *out = stats;
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_pacer_log_stats(void) {
+    struct dongle_pacer_stats s;
+
+    dongle_pacer_get_stats(&s);
+
+    LOG_INF("pacer: %u frames, %u updates applied, %u dropped, %u merged, %u shadowed", s.frames,
+            s.applied, s.dropped, s.merged, s.shadowed);
+}
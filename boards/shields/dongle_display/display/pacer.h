@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// Frame pacing for widget updates: event listeners only store the latest widget state and mark
+// the widget pending. A single work item on the display queue applies all pending widgets at most
+// once per CONFIG_ZMK_DONGLE_DISPLAY_FRAME_PERIOD, so one render covers a whole burst of events.
+// State that must not lose edges within a frame, such as a key press that is released again,
+// latches them until it is applied, see the held halves in status_model.c.
+
+struct dongle_pacer_widget {
+    sys_snode_t node;
+    const char *name;
+    void (*apply)(void);
+    bool pending;
+};
+
+struct dongle_pacer_stats {
+    // paced frames that applied at least one widget
+    uint32_t frames;
+    // widget updates applied
+    uint32_t applied;
+    // states overwritten by a newer one before they were applied
+    uint32_t dropped;
+    // widget updates that shared a frame with another widget instead of rendering on their own
+    uint32_t merged;
+    // requests recorded while suspended
+    uint32_t shadowed;
+};
+
+// Marks the widget pending and arms the next frame if none is armed yet. Safe from any context.
+void dongle_pacer_request(struct dongle_pacer_widget *widget);
+
+// Applies all pending widgets right away, must be called from the display work queue.
+void dongle_pacer_flush(void);
+
+// While suspended requests only update the stored widget state and mark the widget pending, no
+// frame is armed. Resuming applies the latest state of every widget that changed in one batch.
+void dongle_pacer_suspend(void);
+void dongle_pacer_resume(void);
+
+// Overrides the frame period, after_frame (may be NULL) runs on the display queue after every
+// applied batch. A period of 0 restores CONFIG_ZMK_DONGLE_DISPLAY_FRAME_PERIOD. Shortening the
+// period moves an already armed frame to the new due time.
+void dongle_pacer_set_period(uint32_t period_ms, void (*after_frame)(void));
+
+void dongle_pacer_get_stats(struct dongle_pacer_stats *stats);
+void dongle_pacer_log_stats(void);
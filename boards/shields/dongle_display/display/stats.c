@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+#include "anim_sched.h"
+#include "async_flush.h"
+#include "display_power.h"
+#include "flush_tracker.h"
+#include "heap.h"
+#include "heatmap_store.h"
+#include "latency.h"
+#include "motion.h"
+#include "obj_update.h"
+#include "pacer.h"
+#include "stats.h"
+#include "status_model.h"
+
+#include "events/explicit_mods_changed.h"
+#include "events/typing_rate_changed.h"
+
+static int64_t last_report;
+
+void dongle_stats_log(void) {
+    dongle_flush_log_stats();
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_ASYNC_FLUSH)
+    dongle_async_flush_log_stats();
+#endif
+    dongle_anim_log_stats();
+    dongle_motion_log_stats();
+    dongle_pacer_log_stats();
+    dongle_status_log_stats();
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SUSPEND_ON_BLANK) ||                                     \
+    IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_AMBIENT)
+    dongle_display_power_log_stats();
+#endif
+    dongle_obj_update_log_stats();
+    dongle_explicit_mods_log_stats();
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEATMAP)
+    dongle_heatmap_log_stats();
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE)
+    dongle_typing_rate_log_stats();
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LATENCY)
+    dongle_latency_log_stats();
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    dongle_heap_log_stats();
+#endif
+}
+
+void dongle_stats_tick(void) {
+    int64_t now = k_uptime_get();
+
+    if (last_report != 0 && (now - last_report) < CONFIG_ZMK_DONGLE_DISPLAY_STATS_INTERVAL) {
+        return;
+    }
+
+    last_report = now;
+    dongle_stats_log();
+}
+
+static void report_work_cb(struct k_work *work) {
+    last_report = k_uptime_get();
+    dongle_stats_log();
+}
+
+static K_WORK_DEFINE(report_work, report_work_cb);
+
+// Going active reports the wakeups of the idle period that just ended, without waiting for a
+// frame. Runs on the display queue like every other report.
+static int stats_activity_listener(const zmk_event_t *eh) {
+    if (as_zmk_activity_state_changed(eh) == NULL || !zmk_display_is_initialized()) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_work_submit_to_queue(zmk_display_work_q(), &report_work);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_stats, stats_activity_listener);
+ZMK_SUBSCRIPTION(dongle_stats, zmk_activity_state_changed);
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Called at the end of every flushed frame and after every display deadline, logs all display
+// counters at most once per CONFIG_ZMK_DONGLE_DISPLAY_STATS_INTERVAL. A dongle with nothing to
+// draw calls neither, the counters are then reported on every activity state change instead.
+void dongle_stats_tick(void);
+
+void dongle_stats_log(void);
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/battery.h>
+#include <zmk/display.h>
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/events/endpoint_changed.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/keymap.h>
+#include <zmk/usb.h>
+
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+#include <zmk/events/ble_active_profile_changed.h>
+#endif
+
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+#include <zmk/events/usb_conn_state_changed.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+#include <zmk/events/hid_indicators_changed.h>
+#include <zmk/hid_indicators.h>
+#endif
+
+#include "heap.h"
+#include "key_position.h"
+#include "pacer.h"
+#include "status_model.h"
+#include "widget.h"
+#include "events/explicit_mods_changed.h"
+
+static struct dongle_status status;
+static struct dongle_status_stats stats;
+static struct k_spinlock lock;
+static bool loaded;
+
+// halves with a key down right now and halves pressed since the last dispatch
+static uint8_t held;
+static uint8_t pressed;
+
+// Marks the fields in moved as changed by an event raised at timestamp, called with the lock held
+static uint32_t bump(uint32_t moved, int64_t timestamp) {
+    for (int field = 0; field < DONGLE_STATUS_FIELD_COUNT; field++) {
+        if (!(moved & BIT(field))) {
+            continue;
+        }
+
+        status.versions[field]++;
+        if (status.changed_at[field] == 0) {
+            status.changed_at[field] = timestamp;
+        }
+    }
+
+    return moved;
+}
+
+static uint32_t set_battery(struct dongle_status_battery *battery, uint8_t level, bool usb) {
+    if (battery->level == level && battery->usb_present == usb) {
+        return 0;
+    }
+
+    battery->level = level;
+    battery->usb_present = usb;
+    return DONGLE_STATUS_BIT(BATTERY);
+}
+
+// What the model takes from ZMK getters. Some of them call into the Bluetooth host and may block,
+// they are all read before the lock is taken and only the results are applied under it.
+struct status_query {
+    uint8_t layer;
+    uint8_t mods;
+    struct zmk_endpoint_instance endpoint;
+    uint8_t battery_level;
+    uint8_t hid_indicators;
+    uint8_t profile_index;
+    bool connected;
+    bool bonded;
+    enum zmk_usb_conn_state usb;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE)
+    struct dongle_typing_rate typing_rate;
+#endif
+};
+
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+static void query_profile(struct status_query *query) {
+    query->connected = zmk_ble_active_profile_is_connected();
+    query->bonded = !zmk_ble_active_profile_is_open();
+}
+#endif
+
+// Reads only what the event is going to need
+static void query_event(const zmk_event_t *eh, struct status_query *query) {
+    if (as_zmk_layer_state_changed(eh) != NULL) {
+        query->layer = zmk_keymap_highest_layer_active();
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+    if (as_zmk_ble_active_profile_changed(eh) != NULL) {
+        query_profile(query);
+    }
+#endif
+}
+
+static void query_all(struct status_query *query) {
+    query->layer = zmk_keymap_highest_layer_active();
+    query->mods = dongle_explicit_mods_get();
+    query->endpoint = zmk_endpoints_selected();
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
+    query->battery_level = zmk_battery_state_of_charge();
+#endif
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    query->hid_indicators = zmk_hid_indicators_get_current_profile();
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+    query->profile_index = zmk_ble_active_profile_index();
+    query_profile(query);
+#endif
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    query->usb = zmk_usb_get_conn_state();
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE)
+    dongle_typing_rate_get(&query->typing_rate);
+#endif
+}
+
+static uint32_t update_layer(uint8_t layer) {
+    if (status.layer == layer) {
+        return 0;
+    }
+
+    status.layer = layer;
+    return DONGLE_STATUS_BIT(LAYER);
+}
+
+static uint32_t update_keys(const struct zmk_position_state_changed *ev) {
+    const struct dongle_key_position *key = dongle_key_position_get(ev->position);
+    uint8_t side = (key != NULL && key->side == DONGLE_KEY_SIDE_RIGHT) ? DONGLE_STATUS_HELD_RIGHT
+                                                                       : DONGLE_STATUS_HELD_LEFT;
+
+    if (ev->state) {
+        held |= side;
+        pressed |= side;
+    } else {
+        held &= ~side;
+    }
+
+    // the edges survive the coalescing, a paced render still sees a press that was already
+    // released or followed by a press on the other half
+    status.held = held | pressed;
+    return DONGLE_STATUS_BIT(KEYS);
+}
+
+static uint32_t update_output_endpoint(struct zmk_endpoint_instance endpoint) {
+    if (zmk_endpoint_instance_eq(status.output.endpoint, endpoint)) {
+        return 0;
+    }
+
+    status.output.endpoint = endpoint;
+    return DONGLE_STATUS_BIT(OUTPUT);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+static uint32_t update_output_profile(uint8_t index, bool connected, bool bonded) {
+    if (status.output.profile_index == index && status.output.connected == connected &&
+        status.output.bonded == bonded) {
+        return 0;
+    }
+
+    status.output.profile_index = index;
+    status.output.connected = connected;
+    status.output.bonded = bonded;
+    return DONGLE_STATUS_BIT(OUTPUT);
+}
+#endif
+
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+static uint32_t update_usb(enum zmk_usb_conn_state state) {
+    uint32_t moved = 0;
+    bool hid_ready = state == ZMK_USB_CONN_HID;
+
+    if (status.output.usb_hid_ready != hid_ready) {
+        status.output.usb_hid_ready = hid_ready;
+        moved |= DONGLE_STATUS_BIT(OUTPUT);
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
+    moved |= set_battery(&status.central_battery, status.central_battery.level,
+                         state != ZMK_USB_CONN_NONE);
+#endif
+
+    return moved;
+}
+#endif
+
+// Takes everything once, events keep the model current from then on. Called with the lock held.
+static void load(const struct status_query *query) {
+    status.layer = query->layer;
+    status.mods = query->mods;
+    status.output.endpoint = query->endpoint;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
+    status.central_battery.level = query->battery_level;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    status.hid_indicators = query->hid_indicators;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+    update_output_profile(query->profile_index, query->connected, query->bonded);
+#endif
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    update_usb(query->usb);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE)
+    status.typing_rate = query->typing_rate;
+#endif
+}
+
+// Applies the event to the model, called with the lock held. Events without a timestamp of their
+// own keep the one of the raise.
+static uint32_t update(const zmk_event_t *eh, const struct status_query *query,
+                       int64_t *timestamp) {
+    const struct zmk_layer_state_changed *layer_ev = as_zmk_layer_state_changed(eh);
+    if (layer_ev != NULL) {
+        *timestamp = layer_ev->timestamp;
+        return update_layer(query->layer);
+    }
+
+    const struct zmk_position_state_changed *position_ev = as_zmk_position_state_changed(eh);
+    if (position_ev != NULL) {
+        *timestamp = position_ev->timestamp;
+        return update_keys(position_ev);
+    }
+
+    const struct dongle_explicit_mods_changed *mods_ev = as_dongle_explicit_mods_changed(eh);
+    if (mods_ev != NULL) {
+        *timestamp = mods_ev->timestamp;
+        status.mods = mods_ev->new_mods;
+        return DONGLE_STATUS_BIT(MODS);
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE)
+    const struct dongle_typing_rate_changed *rate_ev = as_dongle_typing_rate_changed(eh);
+    if (rate_ev != NULL) {
+        *timestamp = rate_ev->timestamp;
+        status.typing_rate = rate_ev->rate;
+        return DONGLE_STATUS_BIT(TYPING_RATE);
+    }
+#endif
+
+    const struct zmk_peripheral_battery_state_changed *peripheral_ev =
+        as_zmk_peripheral_battery_state_changed(eh);
+    if (peripheral_ev != NULL) {
+        if (peripheral_ev->source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+            return 0;
+        }
+        return set_battery(&status.peripheral_battery[peripheral_ev->source],
+                           peripheral_ev->state_of_charge, false);
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
+    const struct zmk_battery_state_changed *battery_ev = as_zmk_battery_state_changed(eh);
+    if (battery_ev != NULL) {
+        return set_battery(&status.central_battery, battery_ev->state_of_charge,
+                           status.central_battery.usb_present);
+    }
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+    const struct zmk_hid_indicators_changed *indicators_ev = as_zmk_hid_indicators_changed(eh);
+    if (indicators_ev != NULL) {
+        if (status.hid_indicators == indicators_ev->indicators) {
+            return 0;
+        }
+        status.hid_indicators = indicators_ev->indicators;
+        return DONGLE_STATUS_BIT(HID_INDICATORS);
+    }
+#endif
+
+    const struct zmk_endpoint_changed *endpoint_ev = as_zmk_endpoint_changed(eh);
+    if (endpoint_ev != NULL) {
+        return update_output_endpoint(endpoint_ev->endpoint);
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+    const struct zmk_ble_active_profile_changed *profile_ev =
+        as_zmk_ble_active_profile_changed(eh);
+    if (profile_ev != NULL) {
+        return update_output_profile(profile_ev->index, query->connected, query->bonded);
+    }
+#endif
+
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    const struct zmk_usb_conn_state_changed *usb_ev = as_zmk_usb_conn_state_changed(eh);
+    if (usb_ev != NULL) {
+        return update_usb(usb_ev->conn_state);
+    }
+#endif
+
+    return 0;
+}
+
+static void render(const struct dongle_widget *widget, const struct dongle_status *snapshot,
+                   bool initial) {
+    struct dongle_widget_state *state = widget->state;
+    uint32_t changed = 0;
+
+    for (int field = 0; field < DONGLE_STATUS_FIELD_COUNT; field++) {
+        if ((widget->fields & BIT(field)) && state->seen[field] != snapshot->versions[field]) {
+            state->seen[field] = snapshot->versions[field];
+            changed |= BIT(field);
+        }
+    }
+
+    if (!initial && changed == 0) {
+        stats.skipped++;
+        return;
+    }
+
+    stats.renders++;
+    dongle_heap_enter(widget, DONGLE_HEAP_RENDER);
+    widget->render(snapshot, initial ? 0 : changed);
+    dongle_heap_leave();
+}
+
+static struct dongle_pacer_widget status_pacer;
+
+static void dispatch(void) {
+    // kept off the display work queue stack, dispatches never overlap
+    static struct dongle_status snapshot;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    snapshot = status;
+    memset(status.changed_at, 0, sizeof(status.changed_at));
+
+    // presses released within the frame were latched into this snapshot, the next frame drops them
+    bool release = status.held != held;
+    pressed = 0;
+    if (release) {
+        status.held = held;
+        bump(DONGLE_STATUS_BIT(KEYS), k_uptime_get());
+    }
+
+    k_spin_unlock(&lock, key);
+
+    stats.dispatches++;
+
+    STRUCT_SECTION_FOREACH(dongle_widget, widget) {
+        if (widget->state->active) {
+            render(widget, &snapshot, false);
+        }
+    }
+
+    // cleared before apply, so this arms the next paced frame
+    if (release) {
+        dongle_pacer_request(&status_pacer);
+    }
+}
+
+static struct dongle_pacer_widget status_pacer = {
+    .name = "status",
+    .apply = dispatch,
+};
+
+void dongle_widget_activate(const struct dongle_widget *widget) {
+    struct dongle_status snapshot;
+    struct status_query query = {0};
+
+    // only ever set here, on the display work queue
+    if (!loaded) {
+        query_all(&query);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    if (!loaded) {
+        load(&query);
+        loaded = true;
+    }
+    snapshot = status;
+
+    k_spin_unlock(&lock, key);
+
+    widget->state->active = true;
+
+    // renders everything, later dispatches only what moved since this snapshot
+    render(widget, &snapshot, true);
+}
+
+void dongle_widget_deactivate(const struct dongle_widget *widget) { widget->state->active = false; }
+
+static int status_model_listener(const zmk_event_t *eh) {
+    int64_t timestamp = k_uptime_get();
+    struct status_query query = {0};
+
+    query_event(eh, &query);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    stats.events++;
+    uint32_t moved = bump(update(eh, &query, &timestamp), timestamp);
+
+    k_spin_unlock(&lock, key);
+
+    // one work item for every widget, however many fields the event touched
+    if (moved != 0 && zmk_display_is_initialized()) {
+        dongle_pacer_request(&status_pacer);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_status, status_model_listener);
+ZMK_SUBSCRIPTION(dongle_status, zmk_layer_state_changed);
+ZMK_SUBSCRIPTION(dongle_status, dongle_explicit_mods_changed);
+ZMK_SUBSCRIPTION(dongle_status, zmk_peripheral_battery_state_changed);
+ZMK_SUBSCRIPTION(dongle_status, zmk_endpoint_changed);
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BONGO_CAT_WPM)
+ZMK_SUBSCRIPTION(dongle_status, dongle_typing_rate_changed);
+#else
+// only the split bongo cat follows the held keys, typing raises a dispatch per key otherwise
+ZMK_SUBSCRIPTION(dongle_status, zmk_position_state_changed);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
+ZMK_SUBSCRIPTION(dongle_status, zmk_battery_state_changed);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_HID_INDICATORS)
+ZMK_SUBSCRIPTION(dongle_status, zmk_hid_indicators_changed);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_BLE)
+ZMK_SUBSCRIPTION(dongle_status, zmk_ble_active_profile_changed);
+#endif
+#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+ZMK_SUBSCRIPTION(dongle_status, zmk_usb_conn_state_changed);
+#endif
+
+void dongle_status_get_stats(struct dongle_status_stats *out) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    *out = stats;
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_status_log_stats(void) {
+    struct dongle_status_stats s;
+
+    dongle_status_get_stats(&s);
+
+    LOG_INF("status: %u events, %u dispatches, %u renders, %u skipped", s.events, s.dispatches,
+            s.renders, s.skipped);
+}
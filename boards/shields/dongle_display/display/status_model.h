@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <zmk/ble.h>
+#include <zmk/endpoints_types.h>
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE)
+#include "events/typing_rate_changed.h"
+#endif
+
+// Everything the widgets show, kept by a single listener. Each event updates the fields it
+// carries and bumps their version, one paced work item then hands a consistent snapshot to every
+// registered widget whose fields moved since it last rendered, see widget.h. Widgets never query
+// ZMK themselves.
+
+enum dongle_status_field {
+    DONGLE_STATUS_LAYER,
+    DONGLE_STATUS_BATTERY,
+    DONGLE_STATUS_MODS,
+    DONGLE_STATUS_HID_INDICATORS,
+    DONGLE_STATUS_OUTPUT,
+    // bumped on every key press and release, also when the held halves stay the same
+    DONGLE_STATUS_KEYS,
+    DONGLE_STATUS_TYPING_RATE,
+    DONGLE_STATUS_FIELD_COUNT,
+};
+
+#define DONGLE_STATUS_BIT(field) BIT(DONGLE_STATUS_##field)
+
+// Split halves in dongle_status.held
+#define DONGLE_STATUS_HELD_LEFT BIT(0)
+#define DONGLE_STATUS_HELD_RIGHT BIT(1)
+
+struct dongle_status_battery {
+    uint8_t level;
+    bool usb_present;
+};
+
+struct dongle_status_output {
+    struct zmk_endpoint_instance endpoint;
+    uint8_t profile_index;
+    bool connected;
+    bool bonded;
+    bool usb_hid_ready;
+};
+
+struct dongle_status {
+    uint32_t versions[DONGLE_STATUS_FIELD_COUNT];
+    // uptime of the oldest event per field that no dispatch has handed out yet, 0 if none
+    int64_t changed_at[DONGLE_STATUS_FIELD_COUNT];
+
+    uint8_t layer;
+    struct dongle_status_battery central_battery;
+    struct dongle_status_battery peripheral_battery[MAX(ZMK_SPLIT_BLE_PERIPHERAL_COUNT, 1)];
+    uint8_t mods;
+    uint8_t hid_indicators;
+    struct dongle_status_output output;
+    // halves with a key held, plus those pressed since the last dispatch: a press released again
+    // within one frame is still handed out once, followed by a dispatch without it
+    uint8_t held;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE)
+    struct dongle_typing_rate typing_rate;
+#endif
+};
+
+struct dongle_status_stats {
+    uint32_t events;
+    // paced work items that handed out a snapshot
+    uint32_t dispatches;
+    uint32_t renders;
+    // active widgets a dispatch passed over because none of their fields moved
+    uint32_t skipped;
+};
+
+void dongle_status_get_stats(struct dongle_status_stats *stats);
+void dongle_status_log_stats(void);
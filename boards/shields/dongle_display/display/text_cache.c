@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zmk/keymap.h>
+
+#include "text_cache.h"
+
+#define LAYER_TEXT_MAX 12
+
+#define PERCENT_TEXT(n, _) ((n) < 10 ? "   " #n "%" : (n) < 100 ? "  " #n "%" : " " #n "%")
+
+static const char *const percent_text[] = {LISTIFY(101, PERCENT_TEXT, (, ))};
+
+// Indexed by the HID LED bits: num lock 0x01, caps lock 0x02, scroll lock 0x04
+static const char *const hid_lock_text[] = {
+    "", "NLCK", "CLCK", "CNLCK", "SLCK", "NSLCK", "CSLCK", "CNSLCK",
+};
+
+static char layer_buffer[ZMK_KEYMAP_LAYERS_LEN][LAYER_TEXT_MAX + 1];
+static const char *layer_text[ZMK_KEYMAP_LAYERS_LEN];
+
+static void format_index(char *buffer, uint8_t index) {
+    char digits[3];
+    int count = 0;
+
+    do {
+        digits[count++] = '0' + (index % 10);
+        index /= 10;
+    } while (index > 0);
+
+    while (count > 0) {
+        *buffer++ = digits[--count];
+    }
+    *buffer = '\0';
+}
+
+void dongle_text_cache_init(void) {
+    for (uint8_t i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        const char *name = zmk_keymap_layer_name(i);
+
+        if (name == NULL) {
+            format_index(layer_buffer[i], i);
+            layer_text[i] = layer_buffer[i];
+        } else if (strlen(name) > LAYER_TEXT_MAX) {
+            strncpy(layer_buffer[i], name, LAYER_TEXT_MAX);
+            layer_text[i] = layer_buffer[i];
+        } else {
+            // keymap names live in flash for the lifetime of the firmware
+            layer_text[i] = name;
+        }
+    }
+}
+
+const char *dongle_text_layer(uint8_t index) {
+    if (index >= ZMK_KEYMAP_LAYERS_LEN || layer_text[index] == NULL) {
+        return "";
+    }
+
+    return layer_text[index];
+}
+
+const char *dongle_text_percent(uint8_t level) { return percent_text[MIN(level, 100)]; }
+
+const char *dongle_text_hid_locks(uint8_t indicators) {
+    return hid_lock_text[indicators & (ARRAY_SIZE(hid_lock_text) - 1)];
+}
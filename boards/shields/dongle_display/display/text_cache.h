@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// Label texts with static lifetime, meant for lv_label_set_text_static so that neither
+// formatting nor LVGL's heap copy of the string happens on the update path.
+
+// Resolves the layer names once, unnamed layers get their index. Call before the first lookup.
+void dongle_text_cache_init(void);
+
+// Layer name truncated to 12 characters, or the layer index for unnamed layers.
+const char *dongle_text_layer(uint8_t index);
+
+// Battery level right aligned to four columns followed by a percent sign, as "%4u%%".
+const char *dongle_text_percent(uint8_t level);
+
+// Lock indicator text for a HID LED report, e.g. "CNLCK", empty if no lock is on.
+const char *dongle_text_hid_locks(uint8_t indicators);
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#include "heap.h"
+#include "status_model.h"
+
+#if !IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE)
+#include <lvgl.h>
+#endif
+
+// Widgets register a descriptor at build time, the status screen creates and places every
+// registered widget in section order and the status model dispatches to them by walking the same
+// section. Adding a widget means compiling its file, neither the screen nor the model changes.
+//
+// Where a widget draws comes from the zmk,dongle-display-layout node chosen as
+// zmk,dongle-display-layout: its child named like the widget, dashes for underscores, holds the
+// rectangle. The coordinates are compile-time constants, widgets position their objects or
+// pixels from them and nothing is aligned or laid out at run time.
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE)
+// the lite renderer draws into its framebuffer, its widgets have no object and get no parent
+typedef void dongle_widget_obj_t;
+#else
+typedef lv_obj_t dongle_widget_obj_t;
+#endif
+
+enum dongle_region {
+    DONGLE_REGION_BONGO_CAT,
+    DONGLE_REGION_MODIFIERS,
+    DONGLE_REGION_HID_INDICATORS,
+    DONGLE_REGION_LAYER,
+    DONGLE_REGION_BATTERY,
+    DONGLE_REGION_OUTPUT,
+    DONGLE_REGION_HEATMAP,
+    DONGLE_REGION_COUNT,
+};
+
+#if !DT_HAS_CHOSEN(zmk_dongle_display_layout)
+#error "Choose a zmk,dongle-display-layout node as zmk,dongle-display-layout"
+#endif
+
+#define DONGLE_LAYOUT_NODE DT_CHOSEN(zmk_dongle_display_layout)
+#define DONGLE_WIDGET_NODE(_name) DT_CHILD(DONGLE_LAYOUT_NODE, _name)
+
+// The rectangle of the widget, usable in constant expressions
+#define DONGLE_WIDGET_X(_name) DT_PROP_BY_IDX(DONGLE_WIDGET_NODE(_name), rect, 0)
+#define DONGLE_WIDGET_Y(_name) DT_PROP_BY_IDX(DONGLE_WIDGET_NODE(_name), rect, 1)
+#define DONGLE_WIDGET_WIDTH(_name) DT_PROP_BY_IDX(DONGLE_WIDGET_NODE(_name), rect, 2)
+#define DONGLE_WIDGET_HEIGHT(_name) DT_PROP_BY_IDX(DONGLE_WIDGET_NODE(_name), rect, 3)
+
+struct dongle_widget_rect {
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+};
+
+#if !IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE)
+// Gives obj the whole rectangle of the widget. With a fixed size LVGL never measures the content.
+#define DONGLE_WIDGET_SET_RECT(_obj, _name)                                                       \
+    do {                                                                                          \
+        lv_obj_set_pos(_obj, DONGLE_WIDGET_X(_name), DONGLE_WIDGET_Y(_name));                     \
+        lv_obj_set_size(_obj, DONGLE_WIDGET_WIDTH(_name), DONGLE_WIDGET_HEIGHT(_name));           \
+    } while (0)
+#endif
+
+// Stays on the ambient screen, other widgets are hidden there
+#define DONGLE_WIDGET_AMBIENT BIT(0)
+// Destroyed on the ambient screen instead of hidden and created again when it is left. Widgets
+// made of several objects have nothing to hide and must be either this or ambient.
+#define DONGLE_WIDGET_UNLOAD BIT(1)
+
+struct dongle_widget_state {
+    dongle_widget_obj_t *obj;
+    uint32_t seen[DONGLE_STATUS_FIELD_COUNT];
+    bool active;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HEAP_STATS)
+    struct dongle_heap_usage heap;
+#endif
+};
+
+struct dongle_widget {
+    const char *name;
+    enum dongle_region region;
+    struct dongle_widget_rect rect;
+    uint8_t flags;
+    // DONGLE_STATUS_BIT mask of the fields render reads
+    uint32_t fields;
+    // creates the widget objects in its rectangle and returns the one to hide, NULL for widgets
+    // made of several objects. Lite widgets get no parent and may leave this NULL.
+    dongle_widget_obj_t *(*create)(dongle_widget_obj_t *parent);
+    // NULL unless the widget is DONGLE_WIDGET_UNLOAD
+    void (*destroy)(void);
+    // changed holds the fields of the mask whose version moved, 0 on the first render
+    void (*render)(const struct dongle_status *status, uint32_t changed);
+    struct dongle_widget_state *state;
+};
+
+// Registers a widget. order is two digits, widgets are created and rendered in ascending order
+// and later ones are drawn on top. The layout must have a rectangle for it inside the display.
+#define DONGLE_WIDGET_DEFINE(_name, _order, _region, _flags, _fields, _create, _destroy, _render) \
+    BUILD_ASSERT(DT_NODE_EXISTS(DONGLE_WIDGET_NODE(_name)),                                       \
+                 "The display layout has no node for widget " #_name);                            \
+    BUILD_ASSERT(DT_PROP_LEN(DONGLE_WIDGET_NODE(_name), rect) == 4,                               \
+                 "The rect of widget " #_name " must be <x y width height>");                     \
+    BUILD_ASSERT(DONGLE_WIDGET_X(_name) + DONGLE_WIDGET_WIDTH(_name) <=                           \
+                         DT_PROP(DT_CHOSEN(zephyr_display), width) &&                             \
+                     DONGLE_WIDGET_Y(_name) + DONGLE_WIDGET_HEIGHT(_name) <=                      \
+                         DT_PROP(DT_CHOSEN(zephyr_display), height),                              \
+                 "The rect of widget " #_name " is outside the display");                         \
+    static struct dongle_widget_state _CONCAT(dongle_widget_state_, _name);                       \
+    const STRUCT_SECTION_ITERABLE_NAMED(dongle_widget, _CONCAT(_CONCAT(_order, _), _name),        \
+                                        _CONCAT(dongle_widget_, _name)) = {                       \
+        .name = #_name,                                                                           \
+        .region = _region,                                                                        \
+        .rect =                                                                                   \
+            {                                                                                     \
+                .x = DONGLE_WIDGET_X(_name),                                                      \
+                .y = DONGLE_WIDGET_Y(_name),                                                      \
+                .width = DONGLE_WIDGET_WIDTH(_name),                                              \
+                .height = DONGLE_WIDGET_HEIGHT(_name),                                            \
+            },                                                                                    \
+        .flags = _flags,                                                                          \
+        .fields = _fields,                                                                        \
+        .create = _create,                                                                        \
+        .destroy = _destroy,                                                                      \
+        .render = _render,                                                                        \
+        .state = &_CONCAT(dongle_widget_state_, _name),                                           \
+    }
+
+// Marks a created widget active and renders it from the current status right away, dispatches
+// render it again whenever one of its fields moved. Call from the display work queue.
+void dongle_widget_activate(const struct dongle_widget *widget);
+
+// Stops dispatching to the widget, call before destroying it.
+void dongle_widget_deactivate(const struct dongle_widget *widget);
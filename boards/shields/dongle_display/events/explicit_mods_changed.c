@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/hid.h>
+#include <zmk/keys.h>
+
+#include "explicit_mods_changed.h"
+
+ZMK_EVENT_IMPL(dongle_explicit_mods_changed);
+
+static uint8_t last_mods;
+// like the HID report, a modifier stays explicit until every press that registered it is released
+static uint8_t mod_counts[8];
+static uint32_t keycode_events;
+static uint32_t mods_events;
+
+static void count_mods(uint8_t mods, bool pressed) {
+    for (int i = 0; i < ARRAY_SIZE(mod_counts); i++) {
+        if (!(mods & BIT(i))) {
+            continue;
+        }
+
+        if (pressed) {
+            mod_counts[i]++;
+        } else if (mod_counts[i] > 0) {
+            mod_counts[i]--;
+        }
+    }
+}
+
+static uint8_t current_mods(void) {
+    uint8_t mods = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(mod_counts); i++) {
+        if (mod_counts[i] > 0) {
+            mods |= BIT(i);
+        }
+    }
+
+    return mods;
+}
+
+static int explicit_mods_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    uint8_t mods;
+
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    keycode_events++;
+
+    // what hid_listener registers: the explicit modifiers of the binding plus the modifier key
+    // itself, implicit modifiers never reach the explicit mask
+    uint8_t event_mods = ev->explicit_modifiers;
+    if (is_mod(ev->usage_page, ev->keycode)) {
+        event_mods |= BIT(ev->keycode - HID_USAGE_KEY_KEYBOARD_LEFTCONTROL);
+    }
+
+    count_mods(event_mods, ev->state);
+    mods = current_mods();
+    if (mods == last_mods) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    struct dongle_explicit_mods_changed changed = {
+        .old_mods = last_mods,
+        .new_mods = mods,
+        .timestamp = ev->timestamp,
+    };
+
+    last_mods = mods;
+    mods_events++;
+
+    raise_dongle_explicit_mods_changed(changed);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(mods_delta, explicit_mods_listener);
+ZMK_SUBSCRIPTION(mods_delta, zmk_keycode_state_changed);
+
+uint8_t dongle_explicit_mods_get(void) { return last_mods; }
+
+void dongle_explicit_mods_log_stats(void) {
+    LOG_INF("mods: %u keycode events, %u modifier changes", keycode_events, mods_events);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <zmk/event_manager.h>
+
+// Raised after a keycode event only when the explicit modifier mask of the HID report changed,
+// plain key presses never produce one. The mask is derived from the keycode events the same way
+// the HID report counts its explicit modifiers, independent of the order of the listeners.
+struct dongle_explicit_mods_changed {
+    uint8_t old_mods;
+    uint8_t new_mods;
+    int64_t timestamp;
+};
+
+ZMK_EVENT_DECLARE(dongle_explicit_mods_changed);
+
+uint8_t dongle_explicit_mods_get(void);
+
+void dongle_explicit_mods_log_stats(void);
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+#include "typing_rate_changed.h"
+
+ZMK_EVENT_IMPL(dongle_typing_rate_changed);
+
+#define HISTORY CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE_HISTORY
+#define HISTORY_MASK (HISTORY - 1)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(HISTORY), "the press history must be a power of two");
+
+#define LONGEST_WINDOW (DONGLE_TYPING_WINDOW_COUNT - 1)
+
+// the instantaneous rate never divides by less, a chord is not a 1000 keys/s burst
+#define MIN_SPAN_MS 250
+
+static const uint16_t window_ms[DONGLE_TYPING_WINDOW_COUNT] = {1000, 5000, 15000};
+
+// Press uptimes truncated to 32 bits, only differences are ever taken. Presses are numbered from
+// boot, press n lives in history[n & HISTORY_MASK].
+static uint32_t history[HISTORY];
+static uint32_t head;
+// number of the oldest press still inside each window, head - tail[w] presses are in window w
+static uint32_t tail[DONGLE_TYPING_WINDOW_COUNT];
+
+static uint16_t peak;
+static struct dongle_typing_rate current;
+static struct k_spinlock lock;
+
+static uint32_t presses;
+static uint32_t raised;
+static uint32_t overruns;
+
+static void tick_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(tick, tick_handler);
+
+// Every press enters and leaves each window once, so this is O(1) amortized per press.
+static void expire(uint32_t now) {
+    for (int w = 0; w < DONGLE_TYPING_WINDOW_COUNT; w++) {
+        while (tail[w] != head && now - history[tail[w] & HISTORY_MASK] >= window_ms[w]) {
+            tail[w]++;
+        }
+    }
+}
+
+static void push(uint32_t now) {
+    history[head & HISTORY_MASK] = now;
+    head++;
+
+    // a window longer than the history loses its oldest presses and reads low
+    if (head - tail[LONGEST_WINDOW] > HISTORY) {
+        for (int w = 0; w < DONGLE_TYPING_WINDOW_COUNT; w++) {
+            tail[w] = MAX(tail[w], head - HISTORY);
+        }
+        overruns++;
+    }
+}
+
+static struct dongle_typing_rate compute(uint32_t now) {
+    struct dongle_typing_rate rate = {0};
+    uint32_t recent = head - tail[DONGLE_TYPING_WINDOW_1S];
+
+    if (recent > 0) {
+        uint32_t span = MAX(now - history[tail[DONGLE_TYPING_WINDOW_1S] & HISTORY_MASK],
+                            MIN_SPAN_MS);
+
+        rate.keys_per_sec_x10 = MIN(recent * 10000 / span, UINT16_MAX);
+    }
+
+    for (int w = 0; w < DONGLE_TYPING_WINDOW_COUNT; w++) {
+        // (presses / 5) words per (window / 60000) minutes
+        rate.wpm[w] = MIN((head - tail[w]) * 12000 / window_ms[w], UINT16_MAX);
+    }
+
+    // a burst ends once the longest window has drained
+    peak = tail[LONGEST_WINDOW] == head ? 0 : MAX(peak, rate.keys_per_sec_x10);
+    rate.peak_keys_per_sec_x10 = peak;
+
+    return rate;
+}
+
+static void tick_handler(struct k_work *work) {
+    int64_t now = k_uptime_get();
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    expire((uint32_t)now);
+
+    struct dongle_typing_rate rate = compute((uint32_t)now);
+    bool changed = memcmp(&rate, &current, sizeof(rate)) != 0;
+    bool idle = tail[LONGEST_WINDOW] == head;
+
+    current = rate;
+    k_spin_unlock(&lock, key);
+
+    if (changed) {
+        raised++;
+        raise_dongle_typing_rate_changed(
+            (struct dongle_typing_rate_changed){.rate = rate, .timestamp = now});
+    }
+
+    // nothing left to drain, the next press starts the ticks again
+    if (!idle) {
+        k_work_schedule(&tick, K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE_PERIOD));
+    }
+}
+
+static int typing_rate_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+
+    if (ev == NULL || !ev->state) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    push((uint32_t)ev->timestamp);
+    presses++;
+    k_spin_unlock(&lock, key);
+
+    // publishes the first press of a burst right away, later ones wait for the pending tick
+    k_work_schedule(&tick, K_NO_WAIT);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(typing_rate, typing_rate_listener);
+ZMK_SUBSCRIPTION(typing_rate, zmk_position_state_changed);
+
+void dongle_typing_rate_get(struct dongle_typing_rate *rate) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    *rate = current;
+
+    k_spin_unlock(&lock, key);
+}
+
+void dongle_typing_rate_log_stats(void) {
+    struct dongle_typing_rate rate;
+
+    dongle_typing_rate_get(&rate);
+    LOG_INF("typing: %u presses, %u events, %u overruns, wpm %u/%u/%u, peak %u.%u keys/s",
+            presses, raised, overruns, rate.wpm[DONGLE_TYPING_WINDOW_1S],
+            rate.wpm[DONGLE_TYPING_WINDOW_5S], rate.wpm[DONGLE_TYPING_WINDOW_15S],
+            rate.peak_keys_per_sec_x10 / 10, rate.peak_keys_per_sec_x10 % 10);
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <zmk/event_manager.h>
+
+// Typing rate measured on the central from key press timestamps. While keys are being pressed it
+// is recomputed every CONFIG_ZMK_DONGLE_DISPLAY_TYPING_RATE_PERIOD milliseconds and raised when a
+// value changed; once the longest window has drained a final all-zero event is raised and the
+// engine stops waking up.
+
+enum dongle_typing_window {
+    DONGLE_TYPING_WINDOW_1S,
+    DONGLE_TYPING_WINDOW_5S,
+    DONGLE_TYPING_WINDOW_15S,
+    DONGLE_TYPING_WINDOW_COUNT,
+};
+
+struct dongle_typing_rate {
+    // instantaneous rate from the key intervals of the last second, in tenths of keys per second
+    uint16_t keys_per_sec_x10;
+    // highest instantaneous rate of the current burst, reset when typing pauses for 15 s
+    uint16_t peak_keys_per_sec_x10;
+    // rolling words per minute (5 keys a word) per window
+    uint16_t wpm[DONGLE_TYPING_WINDOW_COUNT];
+};
+
+struct dongle_typing_rate_changed {
+    struct dongle_typing_rate rate;
+    int64_t timestamp;
+};
+
+ZMK_EVENT_DECLARE(dongle_typing_rate_changed);
+
+void dongle_typing_rate_get(struct dongle_typing_rate *rate);
+void dongle_typing_rate_log_stats(void);
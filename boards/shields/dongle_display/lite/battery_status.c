@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zmk/ble.h>
+#include <zmk/display.h>
+
+#include "framebuffer.h"
+#include "display/text_cache.h"
+#include "display/widget.h"
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
+    #define SOURCE_OFFSET 1
+#else
+    #define SOURCE_OFFSET 0
+#endif
+
+// One row per source right aligned in the rect: the percentage ends 7 px from the edge, the 5x8
+// symbol fills the last columns.
+#define RIGHT_EDGE (DONGLE_WIDGET_X(battery_status) + DONGLE_WIDGET_WIDTH(battery_status))
+#define SYMBOL_WIDTH 5
+#define SYMBOL_X (RIGHT_EDGE - SYMBOL_WIDTH)
+#define LABEL_WIDTH (5 * DONGLE_LITE_GLYPH_ADVANCE - 1)
+#define LABEL_X (RIGHT_EDGE - 7 - LABEL_WIDTH)
+#define ROW_Y(source) (DONGLE_WIDGET_Y(battery_status) + (source) * 10)
+
+// The glyphs of widgets/battery_status_sym.c in page order: a lit body with the terminals
+// notched into the top row, the gauge is carved out from the top by the number of empty rows.
+#define BATTERY_SIDE 0xfe
+#define BATTERY_GAUGE(empty) (0xff & ~(BIT_MASK(empty) << 2))
+
+#define BATTERY_FILL(empty)                                                                        \
+    {BATTERY_SIDE, BATTERY_GAUGE(empty), BATTERY_GAUGE(empty), BATTERY_GAUGE(empty), BATTERY_SIDE}
+
+static const uint8_t battery_fill[6][SYMBOL_WIDTH] = {
+    BATTERY_FILL(0), BATTERY_FILL(1), BATTERY_FILL(2),
+    BATTERY_FILL(3), BATTERY_FILL(4), BATTERY_FILL(5),
+};
+
+static const uint8_t battery_usb[SYMBOL_WIDTH] = {BATTERY_SIDE, 0x83, 0xbb, 0x83, BATTERY_SIDE};
+
+static const uint8_t *battery_symbol(uint8_t level, bool usb_present) {
+    if (usb_present) {
+        return battery_usb;
+    } else if (level <= 10) {
+        return battery_fill[5];
+    } else if (level <= 30) {
+        return battery_fill[4];
+    } else if (level <= 50) {
+        return battery_fill[3];
+    } else if (level <= 70) {
+        return battery_fill[2];
+    } else if (level <= 90) {
+        return battery_fill[1];
+    }
+
+    return battery_fill[0];
+}
+
+static void draw_row(int row, const struct dongle_status_battery *battery) {
+    int y = ROW_Y(row);
+
+    if (battery->level == 0 && !battery->usb_present) {
+        dongle_lite_fill(LABEL_X, y, RIGHT_EDGE - LABEL_X, 8, false);
+        return;
+    }
+
+    dongle_lite_text(LABEL_X, y, dongle_text_percent(battery->level), LABEL_WIDTH);
+    dongle_lite_blit(SYMBOL_X, y, SYMBOL_WIDTH, 8,
+                     battery_symbol(battery->level, battery->usb_present));
+}
+
+static void battery_status_render(const struct dongle_status *status, uint32_t changed) {
+    // redrawing an unchanged row leaves the framebuffer bytes as they are, nothing is flushed
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
+    draw_row(0, &status->central_battery);
+#endif
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        draw_row(i + SOURCE_OFFSET, &status->peripheral_battery[i]);
+    }
+}
+
+DONGLE_WIDGET_DEFINE(battery_status, 50, DONGLE_REGION_BATTERY, DONGLE_WIDGET_AMBIENT,
+                     DONGLE_STATUS_BIT(BATTERY), NULL, NULL, battery_status_render);
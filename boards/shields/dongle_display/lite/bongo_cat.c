@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zmk/display.h>
+
+#include "framebuffer.h"
+#include "display/anim_engine.h"
+#include "display/widget.h"
+#include "widgets/bongo_cat_anims.h"
+#include "widgets/bongo_cat_frames.h"
+
+#define BONGO_CAT_X DONGLE_WIDGET_X(bongo_cat)
+#define BONGO_CAT_Y DONGLE_WIDGET_Y(bongo_cat)
+
+BUILD_ASSERT(DONGLE_WIDGET_WIDTH(bongo_cat) == BONGO_CAT_WIDTH &&
+                 DONGLE_WIDGET_HEIGHT(bongo_cat) == BONGO_CAT_HEIGHT,
+             "the bongo_cat rect must match the size of the frames");
+
+// Everything one cat animates with, the engine only works on the instance it is passed
+struct bongo_cat {
+    struct dongle_anim_instance anim;
+    // the frame currently in pixels, BONGO_CAT_FRAME_COUNT before the first one
+    enum bongo_cat_frame current;
+    uint8_t pixels[BONGO_CAT_FRAME_SIZE];
+};
+
+static struct bongo_cat cat;
+
+// Same runs as widgets/bongo_cat_decoder.c, over the page-ordered frame bytes
+static void apply_delta(uint8_t *pixels, const uint8_t *delta) {
+    for (;;) {
+        uint8_t skip = *delta++;
+        uint8_t length = *delta++;
+
+        if (skip == 0 && length == 0) {
+            break;
+        }
+
+        pixels += skip;
+        for (uint8_t i = 0; i < length; i++) {
+            *pixels++ ^= *delta++;
+        }
+    }
+}
+
+static void show_frame(struct dongle_anim_instance *anim, uint8_t frame) {
+    struct bongo_cat *owner = CONTAINER_OF(anim, struct bongo_cat, anim);
+
+    if (frame >= BONGO_CAT_FRAME_COUNT || frame == owner->current) {
+        return;
+    }
+
+    if (owner->current == BONGO_CAT_FRAME_COUNT) {
+        memcpy(owner->pixels, bongo_cat_keyframe, BONGO_CAT_FRAME_SIZE);
+    } else {
+        // XOR is its own inverse: undo the current delta to get back to the keyframe
+        apply_delta(owner->pixels, bongo_cat_deltas[owner->current]);
+    }
+
+    apply_delta(owner->pixels, bongo_cat_deltas[frame]);
+    owner->current = frame;
+
+    // unchanged columns compare equal and never reach the display
+    dongle_lite_blit(BONGO_CAT_X, BONGO_CAT_Y, BONGO_CAT_WIDTH, BONGO_CAT_HEIGHT, owner->pixels);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BONGO_CAT_WPM)
+
+#define BONGO_CAT_ANIM bongo_cat_wpm_anim
+#define BONGO_CAT_FIELDS DONGLE_STATUS_BIT(TYPING_RATE)
+
+static void bongo_cat_render(const struct dongle_status *status, uint32_t changed) {
+    uint16_t wpm = status->typing_rate.wpm[DONGLE_TYPING_WINDOW_5S];
+
+    dongle_anim_input(&cat.anim,
+                      dongle_anim_bucket(bongo_cat_wpm_thresholds,
+                                         ARRAY_SIZE(bongo_cat_wpm_thresholds), MIN(wpm, UINT8_MAX)),
+                      false);
+}
+
+#else
+
+#define BONGO_CAT_ANIM bongo_cat_split_anim
+#define BONGO_CAT_FIELDS DONGLE_STATUS_BIT(KEYS)
+
+BUILD_ASSERT(DONGLE_STATUS_HELD_LEFT == BONGO_CAT_SPLIT_LEFT &&
+             DONGLE_STATUS_HELD_RIGHT == BONGO_CAT_SPLIT_RIGHT &&
+             (DONGLE_STATUS_HELD_LEFT | DONGLE_STATUS_HELD_RIGHT) == BONGO_CAT_SPLIT_BOTH);
+
+static void bongo_cat_render(const struct dongle_status *status, uint32_t changed) {
+    if (changed & DONGLE_STATUS_BIT(KEYS)) {
+        dongle_anim_input(&cat.anim, status->held, true);
+    }
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BONGO_CAT_WPM) */
+
+static void *bongo_cat_create(void *parent) {
+    cat.current = BONGO_CAT_FRAME_COUNT;
+    dongle_anim_init(&cat.anim, &BONGO_CAT_ANIM, show_frame);
+    return NULL;
+}
+
+DONGLE_WIDGET_DEFINE(bongo_cat, 10, DONGLE_REGION_BONGO_CAT, 0, BONGO_CAT_FIELDS,
+                     bongo_cat_create, NULL, bongo_cat_render);
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/drivers/display.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "framebuffer.h"
+
+BUILD_ASSERT(DONGLE_LITE_HEIGHT % 8 == 0, "the display height must be a whole number of pages");
+BUILD_ASSERT(DONGLE_LITE_WIDTH <= UINT8_MAX + 1, "dirty columns are tracked in bytes");
+
+static uint8_t fb[DONGLE_LITE_PAGES][DONGLE_LITE_WIDTH];
+
+// changed columns per page, first > last when the page is clean
+static uint8_t dirty_first[DONGLE_LITE_PAGES];
+static uint8_t dirty_last[DONGLE_LITE_PAGES];
+static bool dirty;
+
+// MONO01 controllers get each window inverted through this buffer
+static uint8_t invert_buffer[DONGLE_LITE_WIDTH];
+static bool invert;
+
+static const struct device *fb_display;
+static struct dongle_lite_stats stats;
+
+static void flush_work_cb(struct k_work *work) { dongle_lite_flush(); }
+
+static K_WORK_DEFINE(flush_work, flush_work_cb);
+
+static void mark_clean(int page) {
+    dirty_first[page] = DONGLE_LITE_WIDTH - 1;
+    dirty_last[page] = 0;
+}
+
+// Replaces the masked bits of one framebuffer byte, only real changes are flushed
+static inline void put(int page, int x, uint8_t bits, uint8_t mask) {
+    uint8_t old = fb[page][x];
+    uint8_t new = (old & ~mask) | (bits & mask);
+
+    if (new == old) {
+        return;
+    }
+
+    fb[page][x] = new;
+    dirty_first[page] = MIN(dirty_first[page], x);
+    dirty_last[page] = MAX(dirty_last[page], x);
+
+    if (!dirty) {
+        dirty = true;
+        // runs after the widget updates of this batch, all of them go out in one flush
+        k_work_submit_to_queue(zmk_display_work_q(), &flush_work);
+    }
+}
+
+// Writes one source page column of up to 8 rows starting at pixel row y. Unaligned rows straddle
+// two framebuffer pages.
+static inline void put_column(int x, int y, uint8_t bits, uint8_t mask) {
+    int page = y >> 3;
+    int shift = y & 7;
+
+    if (page >= 0 && page < DONGLE_LITE_PAGES) {
+        put(page, x, bits << shift, mask << shift);
+    }
+
+    if (shift != 0 && page + 1 < DONGLE_LITE_PAGES) {
+        put(page + 1, x, bits >> (8 - shift), mask >> (8 - shift));
+    }
+}
+
+void dongle_lite_blit(int x, int y, int w, int h, const uint8_t *src) {
+    for (int row = 0; row < h; row += 8) {
+        uint8_t mask = h - row >= 8 ? 0xff : BIT_MASK(h - row);
+        // rows above the display only ever come from a negative y
+        int top = y + row;
+
+        if (top <= -8 || top >= DONGLE_LITE_HEIGHT) {
+            src += w;
+            continue;
+        }
+
+        for (int col = 0; col < w; col++) {
+            int px = x + col;
+
+            if (px >= 0 && px < DONGLE_LITE_WIDTH) {
+                if (top < 0) {
+                    put(0, px, src[col] >> -top, mask >> -top);
+                } else {
+                    put_column(px, top, src[col], mask);
+                }
+            }
+        }
+
+        src += w;
+    }
+}
+
+void dongle_lite_fill(int x, int y, int w, int h, bool lit) {
+    uint8_t bits = lit ? 0xff : 0x00;
+    // clip by the far edges first, a rect starting off screen must not grow
+    int x1 = MIN(x + w, DONGLE_LITE_WIDTH);
+    int y1 = MIN(y + h, DONGLE_LITE_HEIGHT);
+
+    x = MAX(x, 0);
+    y = MAX(y, 0);
+
+    for (int row = y; row < y1; row = (row | 7) + 1) {
+        int page = row >> 3;
+        int rows = MIN(8 - (row & 7), y1 - row);
+        uint8_t mask = BIT_MASK(rows) << (row & 7);
+
+        for (int col = x; col < x1; col++) {
+            put(page, col, bits, mask);
+        }
+    }
+}
+
+static const uint8_t *glyph(char c) {
+    uint8_t index = 0;
+
+    if (c >= DONGLE_LITE_FIRST_CHAR && c < DONGLE_LITE_FIRST_CHAR + DONGLE_LITE_CHAR_COUNT) {
+        index = dongle_lite_glyph_index[c - DONGLE_LITE_FIRST_CHAR];
+    }
+
+    return dongle_lite_glyphs[index];
+}
+
+int dongle_lite_text(int x, int y, const char *text, int clear_width) {
+    int width = 0;
+
+    for (; *text != '\0'; text++) {
+        if (width > 0) {
+            dongle_lite_fill(x + width, y, 1, 8, false);
+            width++;
+        }
+
+        dongle_lite_blit(x + width, y, DONGLE_LITE_GLYPH_WIDTH, 8, glyph(*text));
+        width += DONGLE_LITE_GLYPH_WIDTH;
+    }
+
+    if (clear_width > width) {
+        dongle_lite_fill(x + width, y, clear_width - width, 8, false);
+    }
+
+    return width;
+}
+
+static int write_window(int page, int first, int last) {
+    const uint8_t *buf = &fb[page][first];
+    uint16_t width = last - first + 1;
+    struct display_buffer_descriptor desc = {
+        .buf_size = width,
+        .width = width,
+        .height = 8,
+        .pitch = width,
+    };
+
+    if (invert) {
+        for (int i = 0; i < width; i++) {
+            invert_buffer[i] = ~buf[i];
+        }
+        buf = invert_buffer;
+    }
+
+    return display_write(fb_display, first, page * 8, &desc, buf);
+}
+
+void dongle_lite_flush(void) {
+    uint32_t bytes = 0;
+
+    if (!dirty || fb_display == NULL) {
+        return;
+    }
+
+    dirty = false;
+
+    for (int page = 0; page < DONGLE_LITE_PAGES; page++) {
+        int first = dirty_first[page];
+        int last = dirty_last[page];
+
+        if (first > last) {
+            continue;
+        }
+
+        mark_clean(page);
+
+        int err = write_window(page, first, last);
+        if (err) {
+            LOG_WRN("Failed to write page %d (%d)", page, err);
+            continue;
+        }
+
+        stats.windows++;
+        bytes += last - first + 1;
+    }
+
+    if (bytes > 0) {
+        stats.flushes++;
+        stats.total_bytes += bytes;
+        stats.full_frame_bytes += sizeof(fb);
+    }
+}
+
+int dongle_lite_fb_init(const struct device *display) {
+    struct display_capabilities caps;
+
+    display_get_capabilities(display, &caps);
+
+    if (caps.current_pixel_format != PIXEL_FORMAT_MONO10 &&
+        display_set_pixel_format(display, PIXEL_FORMAT_MONO10) != 0) {
+        if (caps.current_pixel_format != PIXEL_FORMAT_MONO01) {
+            return -ENOTSUP;
+        }
+        invert = true;
+    }
+
+    if (!(caps.screen_info & SCREEN_INFO_MONO_VTILED)) {
+        LOG_WRN("Display is not page ordered, the lite renderer assumes it is");
+    }
+
+    fb_display = display;
+
+    // the controller RAM holds whatever was there before, write every page once
+    memset(fb, 0, sizeof(fb));
+    for (int page = 0; page < DONGLE_LITE_PAGES; page++) {
+        dirty_first[page] = 0;
+        dirty_last[page] = DONGLE_LITE_WIDTH - 1;
+    }
+    dirty = true;
+
+    return 0;
+}
+
+void dongle_lite_get_stats(struct dongle_lite_stats *out) { *out = stats; }
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+
+// 1 bpp framebuffer in SSD1306 page order: byte x of page p holds the pixels (x, 8p) to
+// (x, 8p + 7), least significant bit on top. A set bit is a lit pixel. Drawing only changes the
+// framebuffer and remembers the columns of every page that really changed, dongle_lite_flush
+// writes just those windows to the display.
+
+#define DONGLE_LITE_WIDTH DT_PROP(DT_CHOSEN(zephyr_display), width)
+#define DONGLE_LITE_HEIGHT DT_PROP(DT_CHOSEN(zephyr_display), height)
+#define DONGLE_LITE_PAGES (DONGLE_LITE_HEIGHT / 8)
+
+// Images generated by scripts/png_to_lvgl.py --pages: DIV_ROUND_UP(height, 8) pages of width
+// bytes each, in the framebuffer layout.
+struct dongle_lite_image {
+    uint8_t width;
+    uint8_t height;
+    const uint8_t *pages;
+};
+
+// unscii 8 cells generated by scripts/font_subset.py --pages: eight column bytes per glyph for the
+// printable ASCII range, glyph 0 is blank and stands in for characters the font does not have.
+#define DONGLE_LITE_GLYPH_WIDTH 8
+#define DONGLE_LITE_GLYPH_ADVANCE (DONGLE_LITE_GLYPH_WIDTH + 1)
+#define DONGLE_LITE_FIRST_CHAR 0x20
+#define DONGLE_LITE_CHAR_COUNT 95
+
+extern const uint8_t dongle_lite_glyphs[][DONGLE_LITE_GLYPH_WIDTH];
+extern const uint8_t dongle_lite_glyph_index[DONGLE_LITE_CHAR_COUNT];
+
+struct dongle_lite_stats {
+    // flushes that wrote at least one window
+    uint32_t flushes;
+    // page windows written
+    uint32_t windows;
+    uint64_t total_bytes;
+    // what the same number of flushes would have cost as full-screen writes
+    uint64_t full_frame_bytes;
+};
+
+// Takes over the display, the whole framebuffer is written on the first flush.
+int dongle_lite_fb_init(const struct device *display);
+
+// Copies w x h pixels from page-ordered src with a stride of w bytes to (x, y). Pixels outside
+// the display are clipped.
+void dongle_lite_blit(int x, int y, int w, int h, const uint8_t *src);
+
+void dongle_lite_fill(int x, int y, int w, int h, bool lit);
+
+// Draws text with one blank column between glyphs and clears what is left up to clear_width
+// pixels. Returns the width of the drawn text.
+int dongle_lite_text(int x, int y, const char *text, int clear_width);
+
+static inline void dongle_lite_image(int x, int y, const struct dongle_lite_image *image) {
+    dongle_lite_blit(x, y, image->width, image->height, image->pages);
+}
+
+// Writes every changed page window to the display, must run on the display work queue. Drawing
+// schedules a flush on its own, this only forces it earlier.
+void dongle_lite_flush(void);
+
+void dongle_lite_get_stats(struct dongle_lite_stats *stats);
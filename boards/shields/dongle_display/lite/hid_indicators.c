@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zmk/display.h>
+
+#include "framebuffer.h"
+#include "display/text_cache.h"
+#include "display/widget.h"
+
+#define HID_INDICATORS_X DONGLE_WIDGET_X(hid_indicators)
+#define HID_INDICATORS_Y DONGLE_WIDGET_Y(hid_indicators)
+
+static int drawn_width;
+
+static void hid_indicators_render(const struct dongle_status *status, uint32_t changed) {
+    drawn_width = dongle_lite_text(HID_INDICATORS_X, HID_INDICATORS_Y,
+                                   dongle_text_hid_locks(status->hid_indicators), drawn_width);
+}
+
+DONGLE_WIDGET_DEFINE(hid_indicators, 30, DONGLE_REGION_HID_INDICATORS, 0,
+                     DONGLE_STATUS_BIT(HID_INDICATORS), NULL, NULL, hid_indicators_render);
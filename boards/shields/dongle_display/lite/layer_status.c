@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zmk/display.h>
+
+#include "framebuffer.h"
+#include "display/text_cache.h"
+#include "display/widget.h"
+
+#define LAYER_X DONGLE_WIDGET_X(layer_status)
+#define LAYER_Y DONGLE_WIDGET_Y(layer_status)
+
+// width of the previous name, only the part a shorter name leaves behind is cleared
+static int drawn_width;
+
+static void layer_status_render(const struct dongle_status *status, uint32_t changed) {
+    drawn_width = dongle_lite_text(LAYER_X, LAYER_Y, dongle_text_layer(status->layer), drawn_width);
+}
+
+DONGLE_WIDGET_DEFINE(layer_status, 40, DONGLE_REGION_LAYER, DONGLE_WIDGET_AMBIENT,
+                     DONGLE_STATUS_BIT(LAYER), NULL, NULL, layer_status_render);
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+#include "framebuffer.h"
+#include "display/text_cache.h"
+#include "display/widget.h"
+
+// With CONFIG_ZMK_DISPLAY off nothing of ZMK's display code is built, this file provides the
+// display work queue and the initialized flag the pacer and the animation deadlines rely on.
+
+static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+K_THREAD_STACK_DEFINE(dongle_lite_stack, CONFIG_ZMK_DONGLE_DISPLAY_LITE_STACK_SIZE);
+
+static struct k_work_q lite_work_q;
+static bool initialized;
+
+struct k_work_q *zmk_display_work_q(void) { return &lite_work_q; }
+
+bool zmk_display_is_initialized(void) { return initialized; }
+
+static void init_work_cb(struct k_work *work) {
+    int err = dongle_lite_fb_init(display);
+    if (err) {
+        LOG_ERR("Display pixel format not supported (%d)", err);
+        return;
+    }
+
+    dongle_text_cache_init();
+
+    // every widget draws into its rect from the layout
+    STRUCT_SECTION_FOREACH(dongle_widget, widget) {
+        if (widget->create != NULL) {
+            widget->state->obj = widget->create(NULL);
+        }
+        dongle_widget_activate(widget);
+    }
+
+    dongle_lite_flush();
+    display_blanking_off(display);
+
+    initialized = true;
+}
+
+static K_WORK_DEFINE(init_work, init_work_cb);
+
+static int lite_screen_init(void) {
+    if (!device_is_ready(display)) {
+        LOG_ERR("Display device not ready");
+        return -ENODEV;
+    }
+
+    k_work_queue_start(&lite_work_q, dongle_lite_stack, K_THREAD_STACK_SIZEOF(dongle_lite_stack),
+                       CONFIG_ZMK_DONGLE_DISPLAY_LITE_PRIORITY, NULL);
+    k_work_submit_to_queue(&lite_work_q, &init_work);
+
+    return 0;
+}
+
+SYS_INIT(lite_screen_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LITE_BLANK_ON_IDLE)
+
+static bool blank;
+
+static void blank_work_cb(struct k_work *work) {
+    if (blank) {
+        display_blanking_on(display);
+    } else {
+        display_blanking_off(display);
+    }
+}
+
+static K_WORK_DEFINE(blank_work, blank_work_cb);
+
+static int lite_screen_activity_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+
+    if (ev == NULL || !initialized) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    blank = ev->state != ZMK_ACTIVITY_ACTIVE;
+    k_work_submit_to_queue(&lite_work_q, &blank_work);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(lite_screen, lite_screen_activity_listener);
+ZMK_SUBSCRIPTION(lite_screen, zmk_activity_state_changed);
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LITE_BLANK_ON_IDLE) */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zmk/display.h>
+#include <dt-bindings/zmk/modifiers.h>
+
+#include "framebuffer.h"
+#include "display/widget.h"
+
+#define SIZE_SYMBOLS 14
+
+// 15 px per symbol from the rect origin. An active symbol sits one row higher with a two row
+// selection line underneath, the LVGL widget slides between the same two positions.
+#define MODIFIERS_Y DONGLE_WIDGET_Y(modifiers)
+#define SYMBOL_X(i) (DONGLE_WIDGET_X(modifiers) + 1 + (SIZE_SYMBOLS + 1) * (i))
+#define LINE_Y (MODIFIERS_Y + SIZE_SYMBOLS + 1)
+
+struct modifier_symbol {
+    uint8_t modifier;
+    const struct dongle_lite_image *image;
+};
+
+extern const struct dongle_lite_image control_icon;
+extern const struct dongle_lite_image shift_icon;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_MAC_MODIFIERS)
+extern const struct dongle_lite_image opt_icon;
+extern const struct dongle_lite_image cmd_icon;
+
+// this order determines the order of the symbols
+static const struct modifier_symbol modifier_symbols[] = {
+    {MOD_LCTL | MOD_RCTL, &control_icon},
+    {MOD_LALT | MOD_RALT, &opt_icon},
+    {MOD_LGUI | MOD_RGUI, &cmd_icon},
+    {MOD_LSFT | MOD_RSFT, &shift_icon},
+};
+#else
+extern const struct dongle_lite_image alt_icon;
+extern const struct dongle_lite_image win_icon;
+
+// this order determines the order of the symbols
+static const struct modifier_symbol modifier_symbols[] = {
+    {MOD_LGUI | MOD_RGUI, &win_icon},
+    {MOD_LALT | MOD_RALT, &alt_icon},
+    {MOD_LCTL | MOD_RCTL, &control_icon},
+    {MOD_LSFT | MOD_RSFT, &shift_icon},
+};
+#endif
+
+static void modifiers_render(const struct dongle_status *status, uint32_t changed) {
+    for (int i = 0; i < ARRAY_SIZE(modifier_symbols); i++) {
+        bool active = status->mods & modifier_symbols[i].modifier;
+        int y = active ? MODIFIERS_Y : MODIFIERS_Y + 1;
+
+        // the row the symbol moved away from, then the symbol, only changed bytes are flushed
+        dongle_lite_fill(SYMBOL_X(i), active ? y + SIZE_SYMBOLS : MODIFIERS_Y, SIZE_SYMBOLS, 1,
+                         false);
+        dongle_lite_image(SYMBOL_X(i), y, modifier_symbols[i].image);
+        dongle_lite_fill(SYMBOL_X(i), LINE_Y, SIZE_SYMBOLS, 2, active);
+    }
+}
+
+DONGLE_WIDGET_DEFINE(modifiers, 20, DONGLE_REGION_MODIFIERS, 0, DONGLE_STATUS_BIT(MODS), NULL,
+                     NULL, modifiers_render);
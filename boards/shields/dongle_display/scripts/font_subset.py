@@ -0,0 +1,382 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 The ZMK Contributors
+#
+# SPDX-License-Identifier: MIT
+#
+"""Cut an LVGL font down to the glyphs the status screen can show.
+
+Reads a font produced by the LVGL font converter (uncompressed, FORMAT0_TINY character maps such
+as lv_font_unscii_8.c) and writes a copy holding only:
+  - the characters of every layer display-name (and legacy label) of the zmk,keymap node in the
+    final devicetree,
+  - the characters of every string literal in the given widget text sources,
+  - the characters passed with --chars, for text assembled at run time.
+
+Characters the font does not have are reported and skipped. A size report against the full font
+is printed and, with --report, written to a file.
+
+With --pages the glyphs are rendered into 8x8 cells of column bytes in SSD1306 page order for the
+renderer in lite/, with an index table over printable ASCII instead of LVGL character maps. --all
+keeps every glyph of the font.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+STRING = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+ESCAPES = {"n": "\n", "t": "\t", '"': '"', "\\": "\\"}
+
+# the converter's sparse map is binary searched, a handful of ranges is checked one by one
+MAX_RANGES = 4
+
+GLYPH_DSC_SIZE = 8
+CMAP_SIZE = 20
+
+# the printable ASCII range the --pages index table covers, see lite/framebuffer.h
+FIRST_CHAR = 0x20
+CHAR_COUNT = 95
+CELL = 8
+
+
+def unescape(text):
+    return re.sub(r"\\(.)", lambda m: ESCAPES.get(m.group(1), m.group(1)), text)
+
+
+def block(source, start):
+    """Returns the text between the brace at or after start and its matching closing brace."""
+    open_at = source.index("{", start)
+    depth = 0
+    for i in range(open_at, len(source)):
+        if source[i] == "{":
+            depth += 1
+        elif source[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return source[open_at + 1 : i]
+    raise ValueError("unbalanced braces")
+
+
+def keymap_names(dts_path):
+    with open(dts_path) as f:
+        dts = f.read()
+
+    names = []
+    for match in re.finditer(r'compatible\s*=\s*"zmk,keymap"', dts):
+        # the node body starts at the last opening brace before the compatible
+        node_start = dts.rindex("{", 0, match.start())
+        body = block(dts, node_start)
+        for prop in re.finditer(r'\b(?:display-name|label)\s*=\s*' + STRING.pattern, body):
+            names.append(unescape(prop.group(1)))
+    return names
+
+
+def source_strings(path):
+    with open(path) as f:
+        source = f.read()
+    source = re.sub(r"^\s*#\s*include.*$", "", source, flags=re.M)
+    source = re.sub(r"//.*$", "", source, flags=re.M)
+    source = re.sub(r"/\*.*?\*/", "", source, flags=re.S)
+    return [unescape(m.group(1)) for m in STRING.finditer(source)]
+
+
+def fields(text):
+    return {key: value for key, value in re.findall(r"\.(\w+)\s*=\s*([-\w]+)", text)}
+
+
+def parse_font(path):
+    with open(path) as f:
+        source = f.read()
+    # keep the LVGL 8 side of the version checks, the other side repeats the opening braces
+    source = re.sub(r"^#else.*?^#endif", "", source, flags=re.M | re.S)
+
+    bitmap_text = block(source, source.index("glyph_bitmap[]"))
+    bitmap_text = re.sub(r"/\*.*?\*/", "", bitmap_text, flags=re.S)
+    bitmap = [int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]+", bitmap_text)]
+
+    dsc_text = block(source, source.index("glyph_dsc[]"))
+    glyphs = [fields(entry) for entry in re.findall(r"\{([^{}]*)\}", dsc_text)]
+
+    cmaps_text = block(source, source.index("cmaps[]"))
+    cmaps = [fields(entry) for entry in re.findall(r"\{([^{}]*)\}", cmaps_text)]
+
+    font_dsc = fields(block(source, source.index("font_dsc = ")))
+    font = {}
+    for match in re.finditer(r"const lv_font_t \w+ = ", source):
+        font = fields(block(source, match.end() - 1))
+
+    code_to_glyph = {}
+    for cmap in cmaps:
+        if cmap.get("type") != "LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY":
+            sys.exit(f"{path}: only FORMAT0_TINY character maps are supported")
+        start = int(cmap["range_start"])
+        first = int(cmap["glyph_id_start"])
+        for offset in range(int(cmap["range_length"])):
+            code_to_glyph[start + offset] = first + offset
+
+    # a glyph's bitmap runs up to the next glyph's bitmap
+    starts = sorted({int(g["bitmap_index"]) for g in glyphs[1:]} | {len(bitmap)})
+    def glyph_bytes(glyph):
+        index = int(glyph["bitmap_index"])
+        if glyph["box_w"] == "0" or glyph["box_h"] == "0":
+            return []
+        end = next(s for s in starts if s > index)
+        return bitmap[index:end]
+
+    return {
+        "code_to_glyph": code_to_glyph,
+        "glyphs": glyphs,
+        "glyph_bytes": glyph_bytes,
+        "bitmap_size": len(bitmap),
+        "bpp": font_dsc.get("bpp", "1"),
+        "line_height": font.get("line_height", "8"),
+        "base_line": font.get("base_line", "0"),
+        "underline_position": font.get("underline_position", "0"),
+        "underline_thickness": font.get("underline_thickness", "0"),
+        "cmap_count": len(cmaps),
+    }
+
+
+def ranges(codes):
+    runs = []
+    for code in codes:
+        if runs and code == runs[-1][1] + 1:
+            runs[-1][1] = code
+        else:
+            runs.append([code, code])
+    return runs
+
+
+def c_char(code):
+    char = chr(code)
+    return "\\\"" if char == '"' else "\\\\" if char == "\\" else char
+
+
+def emit(font, codes, name, source_name):
+    out = [
+        "/*",
+        " * Copyright (c) 2024 The ZMK Contributors",
+        " *",
+        " * SPDX-License-Identifier: MIT",
+        " */",
+        "",
+        f"// Generated by scripts/font_subset.py from {source_name}, do not edit.",
+        "",
+        "#include <lvgl.h>",
+        "",
+        "static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {",
+    ]
+
+    dsc = ["    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},"]
+    index = 0
+    for code in codes:
+        glyph = font["glyphs"][font["code_to_glyph"][code]]
+        data = font["glyph_bytes"](glyph)
+        out.append(f'    /* U+{code:04X} "{c_char(code)}" */')
+        if data:
+            out.append("    " + ", ".join(f"0x{b:02x}" for b in data) + ",")
+        dsc.append(
+            f"    {{.bitmap_index = {index}, .adv_w = {glyph['adv_w']}, .box_w = {glyph['box_w']}, "
+            f".box_h = {glyph['box_h']}, .ofs_x = {glyph['ofs_x']}, .ofs_y = {glyph['ofs_y']}}},"
+        )
+        index += len(data)
+    if index == 0:
+        out.append("    0x00,")
+        index = 1
+    out += ["};", "", "static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {"] + dsc + ["};", ""]
+
+    runs = ranges(codes)
+    if len(runs) <= MAX_RANGES:
+        cmap_count = len(runs)
+        cmaps = []
+        glyph_id = 1
+        for first, last in runs:
+            cmaps += [
+                "    {",
+                f"        .range_start = {first}, .range_length = {last - first + 1}, "
+                f".glyph_id_start = {glyph_id},",
+                "        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0,",
+                "        .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY,",
+                "    },",
+            ]
+            glyph_id += last - first + 1
+        list_size = 0
+    else:
+        first = codes[0]
+        cmap_count = 1
+        out += [
+            "static const uint16_t unicode_list[] = {",
+            "    " + ", ".join(str(code - first) for code in codes) + ",",
+            "};",
+            "",
+        ]
+        cmaps = [
+            "    {",
+            f"        .range_start = {first}, .range_length = {codes[-1] - first + 1}, "
+            ".glyph_id_start = 1,",
+            f"        .unicode_list = unicode_list, .glyph_id_ofs_list = NULL, "
+            f".list_length = {len(codes)},",
+            "        .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY,",
+            "    },",
+        ]
+        list_size = 2 * len(codes)
+
+    out += ["static const lv_font_fmt_txt_cmap_t cmaps[] = {"] + cmaps + ["};", ""]
+    out += [
+        "static lv_font_fmt_txt_glyph_cache_t cache;",
+        "",
+        "static const lv_font_fmt_txt_dsc_t font_dsc = {",
+        "    .glyph_bitmap = glyph_bitmap,",
+        "    .glyph_dsc = glyph_dsc,",
+        "    .cmaps = cmaps,",
+        "    .kern_dsc = NULL,",
+        "    .kern_scale = 0,",
+        f"    .cmap_num = {cmap_count},",
+        f"    .bpp = {font['bpp']},",
+        "    .kern_classes = 0,",
+        "    .bitmap_format = 0,",
+        "    .cache = &cache,",
+        "};",
+        "",
+        f"const lv_font_t {name} = {{",
+        "    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,",
+        "    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,",
+        f"    .line_height = {font['line_height']},",
+        f"    .base_line = {font['base_line']},",
+        "    .subpx = LV_FONT_SUBPX_NONE,",
+        f"    .underline_position = {font['underline_position']},",
+        f"    .underline_thickness = {font['underline_thickness']},",
+        "    .dsc = &font_dsc,",
+        "};",
+        "",
+    ]
+
+    size = index + (len(codes) + 1) * GLYPH_DSC_SIZE + cmap_count * CMAP_SIZE + list_size
+    return out, size
+
+
+def render_cell(font, glyph):
+    """Column bytes of the glyph in an 8x8 cell, bit 0 on top. Bitmap rows are not byte padded."""
+    data = font["glyph_bytes"](glyph)
+    box_w, box_h = int(glyph["box_w"]), int(glyph["box_h"])
+    top = int(font["line_height"]) - int(font["base_line"]) - box_h - int(glyph["ofs_y"])
+    left = int(glyph["ofs_x"])
+
+    columns = [0] * CELL
+    for gy in range(box_h):
+        for gx in range(box_w):
+            bit = gy * box_w + gx
+            if not data[bit // 8] & (0x80 >> (bit % 8)):
+                continue
+            x, y = left + gx, top + gy
+            if 0 <= x < CELL and 0 <= y < CELL:
+                columns[x] |= 1 << y
+    return columns
+
+
+def emit_pages(font, codes, source_name, include):
+    out = [
+        "/*",
+        " * Copyright (c) 2024 The ZMK Contributors",
+        " *",
+        " * SPDX-License-Identifier: MIT",
+        " */",
+        "",
+        f"// Generated by scripts/font_subset.py from {source_name}, do not edit.",
+        "",
+        f'#include "{include}"',
+        "",
+        "const uint8_t dongle_lite_glyphs[][DONGLE_LITE_GLYPH_WIDTH] = {",
+        "    {0},",
+    ]
+
+    index = [0] * CHAR_COUNT
+    count = 1
+    for code in codes:
+        columns = render_cell(font, font["glyphs"][font["code_to_glyph"][code]])
+        # blank cells such as the space share glyph 0
+        if not any(columns):
+            continue
+        out.append(f'    /* U+{code:04X} "{c_char(code)}" */ {{'
+                   + ", ".join(f"0x{b:02x}" for b in columns) + "},")
+        index[code - FIRST_CHAR] = count
+        count += 1
+
+    out += [
+        "};",
+        "",
+        "const uint8_t dongle_lite_glyph_index[DONGLE_LITE_CHAR_COUNT] = {",
+    ]
+    for i in range(0, CHAR_COUNT, 16):
+        out.append("    " + ", ".join(str(n) for n in index[i : i + 16]) + ",")
+    out += ["};", ""]
+
+    return out, count * CELL + CHAR_COUNT
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("--font", required=True, help="LVGL font source to take the glyphs from")
+    parser.add_argument("--name", required=True, help="name of the generated lv_font_t")
+    parser.add_argument("--dts", help="final devicetree, for the keymap layer names")
+    parser.add_argument("--strings", nargs="*", default=[], help="C sources of widget texts")
+    parser.add_argument("--chars", default="", help="extra characters to keep")
+    parser.add_argument("--all", action="store_true", help="keep every glyph of the font")
+    parser.add_argument("--pages", action="store_true", help="8x8 page-ordered cells for lite/")
+    parser.add_argument("--include", help="--pages: header declaring the glyph tables")
+    parser.add_argument("--report", help="also write the size report to this file")
+    parser.add_argument("output", help="generated C source")
+    args = parser.parse_args()
+
+    texts = [args.chars]
+    if args.dts:
+        texts += keymap_names(args.dts)
+    for path in args.strings:
+        texts += source_strings(path)
+
+    font = parse_font(args.font)
+    if args.all:
+        wanted = sorted(font["code_to_glyph"])
+    else:
+        wanted = sorted({ord(char) for text in texts for char in text})
+    if args.pages:
+        # the lite renderer draws single bytes, anything past ASCII falls back to glyph 0
+        wanted = [code for code in wanted if FIRST_CHAR <= code < FIRST_CHAR + CHAR_COUNT]
+    codes = [code for code in wanted if code in font["code_to_glyph"]]
+    missing = [code for code in wanted if code not in font["code_to_glyph"]]
+
+    if args.pages:
+        if not args.include:
+            sys.exit("--pages needs --include")
+        out, size = emit_pages(font, codes, os.path.basename(args.font), args.include)
+    else:
+        out, size = emit(font, codes, args.name, os.path.basename(args.font))
+
+    full = (
+        font["bitmap_size"]
+        + len(font["glyphs"]) * GLYPH_DSC_SIZE
+        + font["cmap_count"] * CMAP_SIZE
+    )
+    lines = [
+        f"{args.name}: {len(codes)} of {len(font['code_to_glyph'])} glyphs, {size} B instead of "
+        f"{full} B",
+        "  " + "".join(chr(code) for code in codes),
+    ]
+    if missing:
+        lines.append("  not in the font, skipped: " + " ".join(f"U+{c:04X}" for c in missing))
+    print("\n".join(lines))
+
+    if args.report:
+        with open(args.report, "w") as f:
+            f.write("\n".join(lines) + "\n")
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,416 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 The ZMK Contributors
+#
+# SPDX-License-Identifier: MIT
+#
+"""Convert PNG images into packed 1 bpp LVGL image data at build time.
+
+Every pixel that is at least half opaque and darker than mid grey becomes palette index 1 (black),
+everything else index 0 (white), the palette all widgets use. Images are named after their file.
+
+Formats:
+  plain  one const lv_img_dsc_t per image. Identical images share one pixel array and the palette
+         is written once.
+  delta  one keyframe plus XOR run-length deltas for a set of equally sized frames, see
+         widgets/bongo_cat_frames.h. Identical frames share one delta.
+
+With --pages the pixels are packed in SSD1306 page order instead (8 rows per byte, least
+significant bit on top, a row of width bytes per page) for the renderer in lite/, and plain images
+become struct dongle_lite_image declared by the --include header.
+
+A size report is printed and, with --report, written to a file. --budget fails the build when the
+flash used by the generated data grows past it, so new art is never added unnoticed.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+PALETTE = [0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0xFF]
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+MAX_RUN = 255
+
+# bytes LVGL keeps per lv_img_dsc_t besides the pixel data: header, data_size and data pointer
+DSC_SIZE = 12
+# struct dongle_lite_image: width, height and the pages pointer
+LITE_DSC_SIZE = 8
+
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+class Image:
+    def __init__(self, name, width, height, pixels):
+        self.name = name
+        self.width = width
+        self.height = height
+        # packed rows, most significant bit first, as LV_IMG_CF_INDEXED_1BIT stores them, or
+        # packed pages with --pages
+        self.pixels = pixels
+
+    @property
+    def key(self):
+        return (self.width, self.height, bytes(self.pixels))
+
+
+def unfilter(raw, width, height, bpp, bits):
+    stride = (width * bits + 7) // 8
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        kind = raw[pos]
+        row = bytearray(raw[pos + 1 : pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            a = row[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if kind == 1:
+                row[i] = (row[i] + a) & 0xFF
+            elif kind == 2:
+                row[i] = (row[i] + b) & 0xFF
+            elif kind == 3:
+                row[i] = (row[i] + (a + b) // 2) & 0xFF
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                row[i] = (row[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xFF
+            elif kind != 0:
+                raise ValueError(f"unknown PNG filter {kind}")
+        rows.append(row)
+        prev = row
+    return rows
+
+
+def samples(row, width, channels, depth):
+    """Yields per pixel tuples of channel values scaled to 8 bits."""
+    if depth == 8:
+        for x in range(width):
+            yield tuple(row[x * channels : (x + 1) * channels])
+    elif depth == 16:
+        for x in range(width):
+            yield tuple(row[(x * channels + c) * 2] for c in range(channels))
+    else:
+        mask = (1 << depth) - 1
+        for x in range(width):
+            bit = x * depth
+            yield ((row[bit // 8] >> (8 - depth - bit % 8)) & mask,)
+
+
+def read_png(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(PNG_SIGNATURE):
+        raise ValueError(f"{path}: not a PNG file")
+
+    pos = len(PNG_SIGNATURE)
+    idat = bytearray()
+    palette = []
+    transparency = b""
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos : pos + 8])
+        body = data[pos + 8 : pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            palette = [tuple(body[i : i + 3]) for i in range(0, len(body), 3)]
+        elif kind == b"tRNS":
+            transparency = body
+        elif kind == b"IDAT":
+            idat += body
+        elif kind == b"IEND":
+            break
+
+    if interlace:
+        raise ValueError(f"{path}: interlaced PNGs are not supported")
+    if color not in CHANNELS:
+        raise ValueError(f"{path}: unknown PNG color type {color}")
+
+    channels = CHANNELS[color]
+    bits = channels * depth
+    rows = unfilter(zlib.decompress(bytes(idat)), width, height, max(1, bits // 8), bits)
+    scale = 255 // ((1 << depth) - 1) if depth < 8 else 1
+
+    lit = []
+    for row in rows:
+        out = []
+        for s in samples(row, width, channels, depth):
+            if color == 3:
+                r, g, b = palette[s[0]]
+                a = transparency[s[0]] if s[0] < len(transparency) else 255
+            elif color in (0, 4):
+                r = g = b = s[0] * scale
+                a = s[1] if color == 4 else 255
+            else:
+                r, g, b = s[:3]
+                a = s[3] if color == 6 else 255
+            out.append(a >= 128 and (r * 299 + g * 587 + b * 114) // 1000 < 128)
+        lit.append(out)
+    return width, height, lit
+
+
+def pack(width, lit):
+    stride = (width + 7) // 8
+    pixels = []
+    for row in lit:
+        packed = [0] * stride
+        for x, on in enumerate(row):
+            if on:
+                packed[x // 8] |= 0x80 >> (x % 8)
+        pixels += packed
+    return pixels
+
+
+def pack_pages(width, lit):
+    pixels = []
+    for top in range(0, len(lit), 8):
+        rows = lit[top : top + 8]
+        for x in range(width):
+            pixels.append(sum(1 << bit for bit, row in enumerate(rows) if row[x]))
+    return pixels
+
+
+def load(path, pages):
+    width, height, lit = read_png(path)
+    name = os.path.splitext(os.path.basename(path))[0]
+    return Image(name, width, height, pack_pages(width, lit) if pages else pack(width, lit))
+
+
+def encode_delta(xor):
+    """Runs of (skip, length, bytes...) over the XOR with the keyframe, terminated by 0, 0."""
+    ops = []
+    i = 0
+    while i < len(xor):
+        skip = 0
+        while i < len(xor) and xor[i] == 0 and skip < MAX_RUN:
+            i += 1
+            skip += 1
+        if i >= len(xor):
+            break
+        j = i
+        # a single zero inside a literal is cheaper than a new run header
+        while j < len(xor) and j - i < MAX_RUN and not (
+            xor[j] == 0 and (j + 1 >= len(xor) or xor[j + 1] == 0)
+        ):
+            j += 1
+        ops += [skip, j - i] + xor[i:j]
+        i = j
+    return ops + [0, 0]
+
+
+def c_bytes(data, indent="    ", per_line=12):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ", ".join(f"0x{b:02x}" for b in data[i : i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def preamble(sources):
+    return [
+        "/*",
+        " * Copyright (c) 2024 The ZMK Contributors",
+        " *",
+        " * SPDX-License-Identifier: MIT",
+        " */",
+        "",
+        f"// Generated by scripts/png_to_lvgl.py from {sources}, do not edit.",
+        "",
+    ]
+
+
+def emit_plain(images, sources):
+    out = preamble(sources) + [
+        "#include <lvgl.h>",
+        "",
+        "#ifndef LV_ATTRIBUTE_MEM_ALIGN",
+        "#define LV_ATTRIBUTE_MEM_ALIGN",
+        "#endif",
+        "",
+        "// Index 0 white, index 1 black",
+        "#define PALETTE " + ", ".join(f"0x{b:02x}" for b in PALETTE),
+        "",
+    ]
+
+    maps = {}
+    report = []
+    for image in images:
+        shared = maps.get(image.key)
+        if shared is None:
+            shared = maps[image.key] = f"{image.name}_map"
+            out += [
+                f"// {image.width}x{image.height}",
+                "static const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST uint8_t "
+                f"{shared}[] = {{",
+                "    PALETTE,",
+                c_bytes(image.pixels),
+                "};",
+                "",
+            ]
+            size = len(PALETTE) + len(image.pixels)
+        else:
+            size = 0
+        out += [
+            f"const lv_img_dsc_t {image.name} = {{",
+            "    .header.cf = LV_IMG_CF_INDEXED_1BIT,",
+            "    .header.always_zero = 0,",
+            "    .header.reserved = 0,",
+            f"    .header.w = {image.width},",
+            f"    .header.h = {image.height},",
+            f"    .data_size = sizeof({shared}),",
+            f"    .data = {shared},",
+            "};",
+            "",
+        ]
+        report.append((image.name, image, size + DSC_SIZE, shared if size == 0 else None))
+
+    full = sum(len(PALETTE) + len(i.pixels) + DSC_SIZE for i in images)
+    return out, report, full
+
+
+def emit_pages(images, sources, include):
+    out = preamble(sources) + [f'#include "{include}"', ""]
+
+    maps = {}
+    report = []
+    for image in images:
+        shared = maps.get(image.key)
+        if shared is None:
+            shared = maps[image.key] = f"{image.name}_pages"
+            out += [
+                f"// {image.width}x{image.height}",
+                f"static const uint8_t {shared}[] = {{",
+                c_bytes(image.pixels),
+                "};",
+                "",
+            ]
+            size = len(image.pixels)
+        else:
+            size = 0
+        out += [
+            f"const struct dongle_lite_image {image.name} = {{",
+            f"    .width = {image.width},",
+            f"    .height = {image.height},",
+            f"    .pages = {shared},",
+            "};",
+            "",
+        ]
+        report.append((image.name, image, size + LITE_DSC_SIZE, shared if size == 0 else None))
+
+    full = sum(len(i.pixels) + LITE_DSC_SIZE for i in images)
+    return out, report, full
+
+
+def emit_delta(images, sources, keyframe_name, include, symbol, palette):
+    frames = {image.name: image for image in images}
+    if keyframe_name not in frames:
+        sys.exit(f"keyframe {keyframe_name} is not among the frames")
+    keyframe = frames[keyframe_name]
+    for image in images:
+        if (image.width, image.height) != (keyframe.width, keyframe.height):
+            sys.exit(f"{image.name} is {image.width}x{image.height}, the keyframe is "
+                     f"{keyframe.width}x{keyframe.height}")
+
+    upper = symbol.upper()
+    out = preamble(sources) + [
+        f'#include "{include}"',
+        "",
+        f"// {symbol}_{keyframe_name}",
+        f"const uint8_t {symbol}_keyframe[{upper}_FRAME_SIZE] = {{",
+        c_bytes(keyframe.pixels),
+        "};",
+        "",
+    ]
+
+    deltas = {}
+    report = [(f"{symbol}_keyframe", keyframe, len(keyframe.pixels), None)]
+    for image in images:
+        shared = deltas.get(image.key)
+        if shared is None:
+            shared = deltas[image.key] = f"delta_{image.name}"
+            ops = encode_delta([a ^ b for a, b in zip(keyframe.pixels, image.pixels)])
+            out += [
+                f"static const uint8_t {shared}[] = {{",
+                c_bytes(ops),
+                "};",
+                "",
+            ]
+            report.append((image.name, image, len(ops), None))
+        else:
+            report.append((image.name, image, 0, shared))
+
+    out.append(f"const uint8_t *const {symbol}_deltas[{upper}_FRAME_COUNT] = {{")
+    out += [f"    [{upper}_{image.name.upper()}] = {deltas[image.key]}," for image in images]
+    out += ["};", ""]
+
+    full = sum(palette + len(i.pixels) for i in images)
+    return out, report, full
+
+
+def size_report(title, report, full):
+    lines = [f"{title}:"]
+    total = 0
+    for name, image, size, shared in report:
+        total += size
+        note = f" (same as {shared})" if shared else ""
+        lines.append(f"  {name:<24} {image.width:>3}x{image.height:<3} {size:>6} B{note}")
+    lines.append(f"  {'total':<24} {'':7} {total:>6} B, {full} B as separate full images")
+    return lines, total
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("--format", choices=["plain", "delta"], default="plain")
+    parser.add_argument("--keyframe", help="delta: name of the frame the others are XORed with")
+    parser.add_argument("--pages", action="store_true", help="pack in display page order")
+    parser.add_argument("--include", help="delta and --pages: header declaring the data")
+    parser.add_argument("--symbol", help="delta: prefix of the keyframe and delta table")
+    parser.add_argument("--report", help="also write the size report to this file")
+    parser.add_argument("--budget", type=int, help="fail when the data grows past this many bytes")
+    parser.add_argument("output", help="generated C source")
+    parser.add_argument("pngs", nargs="+", help="source images, in frame order for delta")
+    args = parser.parse_args()
+
+    images = [load(path, args.pages) for path in args.pngs]
+    names = [image.name for image in images]
+    duplicates = sorted({name for name in names if names.count(name) > 1})
+    if duplicates:
+        sys.exit(f"duplicate image names: {', '.join(duplicates)}")
+
+    sources = os.path.relpath(os.path.dirname(os.path.abspath(args.pngs[0])),
+                              os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+    if args.format == "delta":
+        if not (args.keyframe and args.include and args.symbol):
+            sys.exit("delta needs --keyframe, --include and --symbol")
+        palette = 0 if args.pages else len(PALETTE)
+        out, report, full = emit_delta(images, sources, args.keyframe, args.include, args.symbol,
+                                       palette)
+    elif args.pages:
+        if not args.include:
+            sys.exit("--pages needs --include")
+        out, report, full = emit_pages(images, sources, args.include)
+    else:
+        out, report, full = emit_plain(images, sources)
+
+    lines, total = size_report(os.path.basename(args.output), report, full)
+    print("\n".join(lines))
+
+    if args.report:
+        with open(args.report, "w") as f:
+            f.write("\n".join(lines) + "\n")
+
+    if args.budget is not None and total > args.budget:
+        sys.exit(f"{os.path.basename(args.output)}: {total} bytes exceed the budget of "
+                 f"{args.budget} bytes")
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
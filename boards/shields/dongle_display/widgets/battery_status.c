@@ -10,15 +10,13 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
-#include <zmk/battery.h>
 #include <zmk/ble.h>
 #include <zmk/display.h>
-#include <zmk/events/battery_state_changed.h>
-#include <zmk/events/usb_conn_state_changed.h>
-#include <zmk/event_manager.h>
-#include <zmk/usb.h>
 
-#include "battery_status.h"
+#include "display/latency.h"
+#include "display/obj_update.h"
+#include "display/text_cache.h"
+#include "display/widget.h"
 
 #if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
     #define SOURCE_OFFSET 1
@@ -26,136 +24,115 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
     #define SOURCE_OFFSET 0
 #endif
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
-
-struct battery_state {
-    uint8_t source;
-    uint8_t level;
-    bool usb_present;
+#define ROW_COUNT (ZMK_SPLIT_BLE_PERIPHERAL_COUNT + SOURCE_OFFSET)
+
+// One row per source right aligned in the rect: the 5 px symbol in the last columns, the
+// percentage ending 7 px from the edge.
+#define ROW_HEIGHT 10
+#define TEXT_HEIGHT 8
+#define RIGHT_EDGE (DONGLE_WIDGET_X(battery_status) + DONGLE_WIDGET_WIDTH(battery_status))
+#define SYMBOL_X (RIGHT_EDGE - 5)
+#define LABEL_WIDTH 44
+#define LABEL_X (RIGHT_EDGE - 7 - LABEL_WIDTH)
+#define ROW_Y(row) (DONGLE_WIDGET_Y(battery_status) + (row) * ROW_HEIGHT)
+
+BUILD_ASSERT((ROW_COUNT - 1) * ROW_HEIGHT + TEXT_HEIGHT <= DONGLE_WIDGET_HEIGHT(battery_status),
+             "the battery_status rect is too low for a row per battery");
+BUILD_ASSERT(DONGLE_WIDGET_WIDTH(battery_status) >= LABEL_WIDTH + 7,
+             "the battery_status rect is too narrow for the percentage");
+
+struct battery_row {
+    lv_obj_t *symbol;
+    lv_obj_t *label;
 };
-    
-static lv_color_t battery_image_buffer[ZMK_SPLIT_BLE_PERIPHERAL_COUNT + SOURCE_OFFSET][5 * 8];
 
-static void draw_battery(lv_obj_t *canvas, uint8_t level, bool usb_present) {
-    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
-    
-    lv_draw_rect_dsc_t rect_fill_dsc;
-    lv_draw_rect_dsc_init(&rect_fill_dsc);
+static struct battery_row rows[ROW_COUNT];
 
-    if (usb_present) {
-        rect_fill_dsc.bg_opa = LV_OPA_TRANSP;
-        rect_fill_dsc.border_color = lv_color_white();
-        rect_fill_dsc.border_width = 1;
-    }
+// shared by every label instead of a local style each
+static const lv_style_const_prop_t label_props[] = {
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_RIGHT),
+    LV_STYLE_PROP_INV,
+};
+
+static LV_STYLE_CONST_INIT(label_style, label_props);
 
-    lv_canvas_set_px(canvas, 0, 0, lv_color_white());
-    lv_canvas_set_px(canvas, 4, 0, lv_color_white());
+LV_IMG_DECLARE(sym_battery_fill_5);
+LV_IMG_DECLARE(sym_battery_fill_4);
+LV_IMG_DECLARE(sym_battery_fill_3);
+LV_IMG_DECLARE(sym_battery_fill_2);
+LV_IMG_DECLARE(sym_battery_fill_1);
+LV_IMG_DECLARE(sym_battery_fill_0);
+LV_IMG_DECLARE(sym_battery_usb);
 
-    if (level <= 10 || usb_present) {
-        lv_canvas_draw_rect(canvas, 1, 2, 3, 5, &rect_fill_dsc);
+static const lv_img_dsc_t *battery_symbol(uint8_t level, bool usb_present) {
+    if (usb_present) {
+        return &sym_battery_usb;
+    } else if (level <= 10) {
+        return &sym_battery_fill_5;
     } else if (level <= 30) {
-        lv_canvas_draw_rect(canvas, 1, 2, 3, 4, &rect_fill_dsc);
+        return &sym_battery_fill_4;
     } else if (level <= 50) {
-        lv_canvas_draw_rect(canvas, 1, 2, 3, 3, &rect_fill_dsc);
+        return &sym_battery_fill_3;
     } else if (level <= 70) {
-        lv_canvas_draw_rect(canvas, 1, 2, 3, 2, &rect_fill_dsc);
+        return &sym_battery_fill_2;
     } else if (level <= 90) {
-        lv_canvas_draw_rect(canvas, 1, 2, 3, 1, &rect_fill_dsc);
+        return &sym_battery_fill_1;
     }
-}
 
-static void set_battery_symbol(lv_obj_t *widget, struct battery_state state) {
-    if (state.source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT + SOURCE_OFFSET) {
-        return;
-    }
-    LOG_DBG("source: %d, level: %d, usb: %d", state.source, state.level, state.usb_present);
-    lv_obj_t *symbol = lv_obj_get_child(widget, state.source * 2);
-    lv_obj_t *label = lv_obj_get_child(widget, state.source * 2 + 1);
-
-    draw_battery(symbol, state.level, state.usb_present);
-    lv_label_set_text_fmt(label, "%4u%%", state.level);
-    
-    if (state.level > 0 || state.usb_present) {
-        lv_obj_clear_flag(symbol, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
-    } else {
-        lv_obj_add_flag(symbol, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
-    }
+    return &sym_battery_fill_0;
 }
 
-void battery_status_update_cb(struct battery_state state) {
-    struct zmk_widget_dongle_battery_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_battery_symbol(widget->obj, state); }
-}
+static void set_battery_symbol(int row, const struct dongle_status_battery *battery) {
+    lv_obj_t *symbol = rows[row].symbol;
+    lv_obj_t *label = rows[row].label;
 
-static struct battery_state peripheral_battery_status_get_state(const zmk_event_t *eh) {
-    const struct zmk_peripheral_battery_state_changed *ev = as_zmk_peripheral_battery_state_changed(eh);
-    return (struct battery_state){
-        .source = ev->source + SOURCE_OFFSET,
-        .level = ev->state_of_charge,
-    };
-}
+    dongle_img_set_src(symbol, battery_symbol(battery->level, battery->usb_present));
+    dongle_label_set_text_static(label, dongle_text_percent(battery->level));
 
-static struct battery_state central_battery_status_get_state(const zmk_event_t *eh) {
-    const struct zmk_battery_state_changed *ev = as_zmk_battery_state_changed(eh);
-    return (struct battery_state) {
-        .source = 0,
-        .level = (ev != NULL) ? ev->state_of_charge : zmk_battery_state_of_charge(),
-#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
-        .usb_present = zmk_usb_is_powered(),
-#endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
-    };
+    bool hidden = battery->level == 0 && !battery->usb_present;
+    dongle_obj_set_hidden(symbol, hidden);
+    dongle_obj_set_hidden(label, hidden);
 }
 
-static struct battery_state battery_status_get_state(const zmk_event_t *eh) { 
-    if (as_zmk_peripheral_battery_state_changed(eh) != NULL) {
-        return peripheral_battery_status_get_state(eh);
-    } else {
-        return central_battery_status_get_state(eh);
+static void battery_status_render(const struct dongle_status *status, uint32_t changed) {
+    if (changed & DONGLE_STATUS_BIT(BATTERY)) {
+        dongle_latency_mark(DONGLE_REGION_BATTERY, status->changed_at[DONGLE_STATUS_BATTERY]);
     }
-}
-
-ZMK_DISPLAY_WIDGET_LISTENER(widget_dongle_battery_status, struct battery_state,
-                            battery_status_update_cb, battery_status_get_state)
-
-ZMK_SUBSCRIPTION(widget_dongle_battery_status, zmk_peripheral_battery_state_changed);
 
+    // unchanged rows compare equal in the setters and cost no redraw
 #if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY)
-#if !IS_ENABLED(CONFIG_ZMK_SPLIT) || IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
-
-ZMK_SUBSCRIPTION(widget_dongle_battery_status, zmk_battery_state_changed);
-#if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
-ZMK_SUBSCRIPTION(widget_dongle_battery_status, zmk_usb_conn_state_changed);
-#endif /* IS_ENABLED(CONFIG_USB_DEVICE_STACK) */
-#endif /* !IS_ENABLED(CONFIG_ZMK_SPLIT) || IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) */
-#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DONGLE_BATTERY) */
+    set_battery_symbol(0, &status->central_battery);
+#endif
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        set_battery_symbol(i + SOURCE_OFFSET, &status->peripheral_battery[i]);
+    }
 
-int zmk_widget_dongle_battery_status_init(struct zmk_widget_dongle_battery_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_obj_create(parent);
+    if (changed & DONGLE_STATUS_BIT(BATTERY)) {
+        dongle_latency_applied(DONGLE_REGION_BATTERY);
+    }
+}
 
-    lv_obj_set_size(widget->obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
-    
-    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT + SOURCE_OFFSET; i++) {
-        lv_obj_t *image_canvas = lv_canvas_create(widget->obj);
-        lv_obj_t *battery_label = lv_label_create(widget->obj);
+static lv_obj_t *battery_status_create(lv_obj_t *parent) {
+    // straight on the screen, a container would only add an object and a layout pass
+    for (int i = 0; i < ROW_COUNT; i++) {
+        rows[i].symbol = lv_img_create(parent);
+        rows[i].label = lv_label_create(parent);
 
-        lv_canvas_set_buffer(image_canvas, battery_image_buffer[i], 5, 8, LV_IMG_CF_TRUE_COLOR);
+        lv_img_set_src(rows[i].symbol, &sym_battery_fill_0);
+        lv_obj_set_pos(rows[i].symbol, SYMBOL_X, ROW_Y(i));
 
-        lv_obj_align(image_canvas, LV_ALIGN_TOP_RIGHT, 0, i * 10);
-        lv_obj_align(battery_label, LV_ALIGN_TOP_RIGHT, -7, i * 10);
+        lv_label_set_long_mode(rows[i].label, LV_LABEL_LONG_CLIP);
+        lv_obj_add_style(rows[i].label, (lv_style_t *)&label_style, LV_PART_MAIN);
+        lv_obj_set_pos(rows[i].label, LABEL_X, ROW_Y(i));
+        lv_obj_set_size(rows[i].label, LABEL_WIDTH, TEXT_HEIGHT);
 
-        lv_obj_add_flag(image_canvas, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(battery_label, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(rows[i].symbol, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(rows[i].label, LV_OBJ_FLAG_HIDDEN);
     }
 
-    sys_slist_append(&widgets, &widget->node);
-
-    widget_dongle_battery_status_init();
-
-    return 0;
+    return NULL;
 }
 
-lv_obj_t *zmk_widget_dongle_battery_status_obj(struct zmk_widget_dongle_battery_status *widget) {
-    return widget->obj;
-}
+DONGLE_WIDGET_DEFINE(battery_status, 50, DONGLE_REGION_BATTERY, DONGLE_WIDGET_AMBIENT,
+                     DONGLE_STATUS_BIT(BATTERY), battery_status_create, NULL,
+                     battery_status_render);
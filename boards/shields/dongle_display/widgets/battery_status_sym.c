@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <lvgl.h>
+
+#ifndef LV_ATTRIBUTE_MEM_ALIGN
+#define LV_ATTRIBUTE_MEM_ALIGN
+#endif
+
+// 5x8 battery glyphs: two terminal pixels on the top row and a 3 px wide gauge starting on row 2.
+// Index 0 is black and index 1 white: a white gauge on a black background.
+#define BATTERY_PALETTE                                                                            \
+    0x00, 0x00, 0x00, 0xff, /*Color of index 0*/                                                   \
+    0xff, 0xff, 0xff, 0xff  /*Color of index 1*/
+
+#define BATTERY_TERMINALS 0x88
+#define BATTERY_GAUGE_FULL 0x70
+#define BATTERY_GAUGE_SIDES 0x50
+
+#define BATTERY_FILL_ROW(fill, row) (((row) >= 2 && (row) < 2 + (fill)) ? BATTERY_GAUGE_FULL : 0x00)
+
+#define BATTERY_FILL_MAP(fill)                                                                     \
+    BATTERY_PALETTE, BATTERY_TERMINALS, 0x00, BATTERY_FILL_ROW(fill, 2),                           \
+        BATTERY_FILL_ROW(fill, 3), BATTERY_FILL_ROW(fill, 4), BATTERY_FILL_ROW(fill, 5),           \
+        BATTERY_FILL_ROW(fill, 6), 0x00
+
+#define BATTERY_OUTLINE_MAP                                                                        \
+    BATTERY_PALETTE, BATTERY_TERMINALS, 0x00, BATTERY_GAUGE_FULL, BATTERY_GAUGE_SIDES,             \
+        BATTERY_GAUGE_SIDES, BATTERY_GAUGE_SIDES, BATTERY_GAUGE_FULL, 0x00
+
+#define BATTERY_GLYPH(name, ...)                                                                   \
+    static const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST uint8_t name##_map[] = {          \
+        __VA_ARGS__};                                                                              \
+    const lv_img_dsc_t name = {                                                                    \
+        .header.cf = LV_IMG_CF_INDEXED_1BIT,                                                       \
+        .header.always_zero = 0,                                                                   \
+        .header.reserved = 0,                                                                      \
+        .header.w = 5,                                                                             \
+        .header.h = 8,                                                                             \
+        .data_size = sizeof(name##_map),                                                           \
+        .data = name##_map,                                                                        \
+    }
+
+BATTERY_GLYPH(sym_battery_fill_5, BATTERY_FILL_MAP(5));
+BATTERY_GLYPH(sym_battery_fill_4, BATTERY_FILL_MAP(4));
+BATTERY_GLYPH(sym_battery_fill_3, BATTERY_FILL_MAP(3));
+BATTERY_GLYPH(sym_battery_fill_2, BATTERY_FILL_MAP(2));
+BATTERY_GLYPH(sym_battery_fill_1, BATTERY_FILL_MAP(1));
+BATTERY_GLYPH(sym_battery_fill_0, BATTERY_FILL_MAP(0));
+BATTERY_GLYPH(sym_battery_usb, BATTERY_OUTLINE_MAP);
@@ -5,144 +5,97 @@
  */
 
 #include <zephyr/kernel.h>
-#include <zephyr/bluetooth/services/bas.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/event_manager.h>
-#include <zmk/events/wpm_state_changed.h>
-#include <zmk/wpm.h>
-
-#include "bongo_cat.h"
-
-#define SRC(array) (const void **)array, sizeof(array) / sizeof(lv_img_dsc_t *)
-
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
-
-LV_IMG_DECLARE(bongo_cat_none);
-LV_IMG_DECLARE(bongo_cat_left1);
-LV_IMG_DECLARE(bongo_cat_left2);
-LV_IMG_DECLARE(bongo_cat_right1);
-LV_IMG_DECLARE(bongo_cat_right2);
-LV_IMG_DECLARE(bongo_cat_both1);
-LV_IMG_DECLARE(bongo_cat_both1_open);
-LV_IMG_DECLARE(bongo_cat_both2);
-
-#define ANIMATION_SPEED_IDLE 10000
-const lv_img_dsc_t *idle_imgs[] = {
-    &bongo_cat_both1_open,
-    &bongo_cat_both1_open,
-    &bongo_cat_both1_open,
-    &bongo_cat_both1,
-};
 
-#define ANIMATION_SPEED_SLOW 2000
-const lv_img_dsc_t *slow_imgs[] = {
-    &bongo_cat_left1,
-    &bongo_cat_both1,
-    &bongo_cat_both1,
-    &bongo_cat_right1,
-    &bongo_cat_both1,
-    &bongo_cat_both1,
-    &bongo_cat_left1,
-    &bongo_cat_both1,
-    &bongo_cat_both1,
+#include "bongo_cat_anims.h"
+#include "bongo_cat_frames.h"
+#include "display/anim_engine.h"
+#include "display/latency.h"
+#include "display/widget.h"
+
+// Everything one cat animates with, the engine and the decoder only work on what they are passed
+struct bongo_cat {
+    lv_obj_t *img;
+    struct dongle_anim_instance anim;
+    struct bongo_cat_frame_buffer frames;
 };
 
-#define ANIMATION_SPEED_MID 500
-const lv_img_dsc_t *mid_imgs[] = {
-    &bongo_cat_left2,
-    &bongo_cat_left1,
-    &bongo_cat_none,
-    &bongo_cat_right2,
-    &bongo_cat_right1,
-    &bongo_cat_none,
-};
+static struct bongo_cat cat;
 
-#define ANIMATION_SPEED_FAST 200
-const lv_img_dsc_t *fast_imgs[] = {
-    &bongo_cat_both2,
-    &bongo_cat_both1,
-    &bongo_cat_none,
-    &bongo_cat_none,
-};
-
-struct bongo_cat_wpm_status_state {
-    uint8_t wpm;
-};
+static void show_frame(struct dongle_anim_instance *anim, uint8_t frame) {
+    struct bongo_cat *owner = CONTAINER_OF(anim, struct bongo_cat, anim);
+    uint8_t first_row, last_row;
 
-enum anim_state {
-    anim_state_none,
-    anim_state_idle,
-    anim_state_slow,
-    anim_state_mid,
-    anim_state_fast
-} current_anim_state;
-
-static void set_animation(lv_obj_t *animing, struct bongo_cat_wpm_status_state state) {
-    if (state.wpm < 5) {
-        if (current_anim_state != anim_state_idle) {
-            lv_animimg_set_src(animing, SRC(idle_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_IDLE);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_idle;
-        }
-    } else if (state.wpm < 30) {
-        if (current_anim_state != anim_state_slow) {
-            lv_animimg_set_src(animing, SRC(slow_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_SLOW);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_slow;
-        }
-    } else if (state.wpm < 70) {
-        if (current_anim_state != anim_state_mid) {
-            lv_animimg_set_src(animing, SRC(mid_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_MID);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_mid;
-        }
-    } else {
-        if (current_anim_state != anim_state_fast) {
-            lv_animimg_set_src(animing, SRC(fast_imgs));
-            lv_animimg_set_duration(animing, ANIMATION_SPEED_FAST);
-            lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
-            lv_animimg_start(animing);
-            current_anim_state = anim_state_fast;
-        }
+    // decode in place and redraw only the changed rows
+    if (bongo_cat_frame_show(&owner->frames, frame, &first_row, &last_row)) {
+        bongo_cat_frame_invalidate(owner->img, first_row, last_row);
     }
 }
 
-struct bongo_cat_wpm_status_state bongo_cat_wpm_status_get_state(const zmk_event_t *eh) {
-    struct zmk_wpm_state_changed *ev = as_zmk_wpm_state_changed(eh);
-    return (struct bongo_cat_wpm_status_state) { .wpm = ev->state };
-};
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BONGO_CAT_WPM)
+
+#define BONGO_CAT_ANIM bongo_cat_wpm_anim
+#define BONGO_CAT_FIELDS DONGLE_STATUS_BIT(TYPING_RATE)
 
-void bongo_cat_wpm_status_update_cb(struct bongo_cat_wpm_status_state state) {
-    struct zmk_widget_bongo_cat *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_animation(widget->obj, state); }
+static void bongo_cat_render(const struct dongle_status *status, uint32_t changed) {
+    // the 5 s window follows a burst within a few hundred milliseconds without flickering
+    uint16_t wpm = status->typing_rate.wpm[DONGLE_TYPING_WINDOW_5S];
+
+    dongle_anim_input(&cat.anim,
+                      dongle_anim_bucket(bongo_cat_wpm_thresholds,
+                                         ARRAY_SIZE(bongo_cat_wpm_thresholds), MIN(wpm, UINT8_MAX)),
+                      false);
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_bongo_cat, struct bongo_cat_wpm_status_state,
-                            bongo_cat_wpm_status_update_cb, bongo_cat_wpm_status_get_state)
+#else
 
-ZMK_SUBSCRIPTION(widget_bongo_cat, zmk_wpm_state_changed);
+#define BONGO_CAT_ANIM bongo_cat_split_anim
+#define BONGO_CAT_FIELDS DONGLE_STATUS_BIT(KEYS)
 
-int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget, lv_obj_t *parent) {
-    widget->obj = lv_animimg_create(parent);
-    lv_obj_center(widget->obj);
+// the held halves of the status model double as the animation input
+BUILD_ASSERT(DONGLE_STATUS_HELD_LEFT == BONGO_CAT_SPLIT_LEFT &&
+             DONGLE_STATUS_HELD_RIGHT == BONGO_CAT_SPLIT_RIGHT &&
+             (DONGLE_STATUS_HELD_LEFT | DONGLE_STATUS_HELD_RIGHT) == BONGO_CAT_SPLIT_BOTH);
 
-    sys_slist_append(&widgets, &widget->node);
+static void bongo_cat_render(const struct dongle_status *status, uint32_t changed) {
+    if (!(changed & DONGLE_STATUS_BIT(KEYS))) {
+        return;
+    }
 
-    widget_bongo_cat_init();
+    dongle_latency_mark(DONGLE_REGION_BONGO_CAT, status->changed_at[DONGLE_STATUS_KEYS]);
+    // re-entering the released state restarts the cheering cooldown
+    dongle_anim_input(&cat.anim, status->held, true);
+    dongle_latency_applied(DONGLE_REGION_BONGO_CAT);
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BONGO_CAT_WPM) */
+
+static lv_obj_t *bongo_cat_create(lv_obj_t *parent) {
+    bongo_cat_frame_init(&cat.frames);
+
+    cat.img = lv_img_create(parent);
+    lv_obj_set_pos(cat.img, DONGLE_WIDGET_X(bongo_cat), DONGLE_WIDGET_Y(bongo_cat));
+    lv_img_set_src(cat.img, &cat.frames.img);
 
-    return 0;
+    dongle_anim_init(&cat.anim, &BONGO_CAT_ANIM, show_frame);
+
+    return cat.img;
+}
+
+static void bongo_cat_destroy(void) {
+    // nothing left to animate, create starts over from the initial state
+    dongle_anim_stop(&cat.anim);
+    lv_obj_del(cat.img);
+    cat.img = NULL;
 }
 
-lv_obj_t *zmk_widget_bongo_cat_obj(struct zmk_widget_bongo_cat *widget) {
-    return widget->obj;
-}
\ No newline at end of file
+BUILD_ASSERT(DONGLE_WIDGET_WIDTH(bongo_cat) == BONGO_CAT_WIDTH &&
+                 DONGLE_WIDGET_HEIGHT(bongo_cat) == BONGO_CAT_HEIGHT,
+             "the bongo_cat rect must match the size of the frames");
+
+DONGLE_WIDGET_DEFINE(bongo_cat, 10, DONGLE_REGION_BONGO_CAT, DONGLE_WIDGET_UNLOAD,
+                     BONGO_CAT_FIELDS, bongo_cat_create, bongo_cat_destroy, bongo_cat_render);
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "bongo_cat_anims.h"
+#include "bongo_cat_frames.h"
+
+// Split: paws follow the halves with keys held, the cat cheers for 5 s after the last release
+// and then rests with both paws on the table.
+
+enum split_state {
+    SPLIT_IDLE,
+    SPLIT_ACTIVE,
+    SPLIT_LEFT,
+    SPLIT_RIGHT,
+    SPLIT_BOTH,
+};
+
+static const struct dongle_anim_state split_states[] = {
+    [SPLIT_IDLE] = {DONGLE_ANIM_FRAMES(BONGO_CAT_BOTH1_OPEN)},
+    [SPLIT_ACTIVE] = {DONGLE_ANIM_FRAMES(BONGO_CAT_NONE), .timeout_ms = 5000,
+                      .timeout_state = SPLIT_IDLE},
+    [SPLIT_LEFT] = {DONGLE_ANIM_FRAMES(BONGO_CAT_LEFT2)},
+    [SPLIT_RIGHT] = {DONGLE_ANIM_FRAMES(BONGO_CAT_RIGHT2)},
+    [SPLIT_BOTH] = {DONGLE_ANIM_FRAMES(BONGO_CAT_BOTH2)},
+};
+
+static const struct dongle_anim_transition split_transitions[] = {
+    {DONGLE_ANIM_ANY, BONGO_CAT_SPLIT_RELEASED, SPLIT_ACTIVE},
+    {DONGLE_ANIM_ANY, BONGO_CAT_SPLIT_LEFT, SPLIT_LEFT},
+    {DONGLE_ANIM_ANY, BONGO_CAT_SPLIT_RIGHT, SPLIT_RIGHT},
+    {DONGLE_ANIM_ANY, BONGO_CAT_SPLIT_BOTH, SPLIT_BOTH},
+};
+
+const struct dongle_anim_def bongo_cat_split_anim = {
+    .states = split_states,
+    .state_count = ARRAY_SIZE(split_states),
+    .transitions = split_transitions,
+    .transition_count = ARRAY_SIZE(split_transitions),
+    .initial_state = SPLIT_IDLE,
+};
+
+// WPM: the drumming speeds up with the typing speed. Frame times are the former lv_animimg cycle
+// durations (10000, 2000, 500 and 200 ms) divided by the number of frames.
+
+const uint8_t bongo_cat_wpm_thresholds[] = {5, 30, 70};
+
+static const struct dongle_anim_state wpm_states[] = {
+    [BONGO_CAT_WPM_IDLE] = {DONGLE_ANIM_FRAMES(BONGO_CAT_BOTH1_OPEN, BONGO_CAT_BOTH1_OPEN,
+                                               BONGO_CAT_BOTH1_OPEN, BONGO_CAT_BOTH1),
+                            .frame_ms = 2500},
+    [BONGO_CAT_WPM_SLOW] = {DONGLE_ANIM_FRAMES(BONGO_CAT_LEFT1, BONGO_CAT_BOTH1, BONGO_CAT_BOTH1,
+                                               BONGO_CAT_RIGHT1, BONGO_CAT_BOTH1, BONGO_CAT_BOTH1,
+                                               BONGO_CAT_LEFT1, BONGO_CAT_BOTH1, BONGO_CAT_BOTH1),
+                            .frame_ms = 222},
+    [BONGO_CAT_WPM_MID] = {DONGLE_ANIM_FRAMES(BONGO_CAT_LEFT2, BONGO_CAT_LEFT1, BONGO_CAT_NONE,
+                                              BONGO_CAT_RIGHT2, BONGO_CAT_RIGHT1, BONGO_CAT_NONE),
+                           .frame_ms = 83},
+    [BONGO_CAT_WPM_FAST] = {DONGLE_ANIM_FRAMES(BONGO_CAT_BOTH2, BONGO_CAT_BOTH1, BONGO_CAT_NONE,
+                                               BONGO_CAT_NONE),
+                            .frame_ms = 50},
+};
+
+static const struct dongle_anim_transition wpm_transitions[] = {
+    {DONGLE_ANIM_ANY, BONGO_CAT_WPM_IDLE, BONGO_CAT_WPM_IDLE},
+    {DONGLE_ANIM_ANY, BONGO_CAT_WPM_SLOW, BONGO_CAT_WPM_SLOW},
+    {DONGLE_ANIM_ANY, BONGO_CAT_WPM_MID, BONGO_CAT_WPM_MID},
+    {DONGLE_ANIM_ANY, BONGO_CAT_WPM_FAST, BONGO_CAT_WPM_FAST},
+};
+
+const struct dongle_anim_def bongo_cat_wpm_anim = {
+    .states = wpm_states,
+    .state_count = ARRAY_SIZE(wpm_states),
+    .transitions = wpm_transitions,
+    .transition_count = ARRAY_SIZE(wpm_transitions),
+    .initial_state = BONGO_CAT_WPM_IDLE,
+};
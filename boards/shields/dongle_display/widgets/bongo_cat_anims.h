@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "display/anim_engine.h"
+
+// Inputs of the split animation: the set of halves with a key held, or none after the last
+// release.
+enum bongo_cat_split_input {
+    BONGO_CAT_SPLIT_RELEASED,
+    BONGO_CAT_SPLIT_LEFT,
+    BONGO_CAT_SPLIT_RIGHT,
+    BONGO_CAT_SPLIT_BOTH,
+};
+
+// Inputs of the WPM animation: the bucket of the current WPM in bongo_cat_wpm_thresholds.
+enum bongo_cat_wpm_input {
+    BONGO_CAT_WPM_IDLE,
+    BONGO_CAT_WPM_SLOW,
+    BONGO_CAT_WPM_MID,
+    BONGO_CAT_WPM_FAST,
+    BONGO_CAT_WPM_INPUT_COUNT,
+};
+
+extern const uint8_t bongo_cat_wpm_thresholds[BONGO_CAT_WPM_INPUT_COUNT - 1];
+
+extern const struct dongle_anim_def bongo_cat_split_anim;
+extern const struct dongle_anim_def bongo_cat_wpm_anim;
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include "bongo_cat_frames.h"
+
+// Palette of the original images: index 0 white, index 1 black
+static const uint8_t palette[BONGO_CAT_PALETTE_SIZE] = {
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0xff,
+};
+
+// XORs a delta into the pixels and widens [*lo, *hi] to cover the touched bytes
+static void apply_delta(uint8_t *pixels, const uint8_t *delta, int *lo, int *hi) {
+    int offset = 0;
+
+    for (;;) {
+        uint8_t skip = *delta++;
+        uint8_t length = *delta++;
+
+        if (skip == 0 && length == 0) {
+            break;
+        }
+
+        offset += skip;
+        *lo = MIN(*lo, offset);
+        *hi = MAX(*hi, offset + length - 1);
+
+        for (uint8_t i = 0; i < length; i++) {
+            pixels[offset++] ^= *delta++;
+        }
+    }
+}
+
+void bongo_cat_frame_init(struct bongo_cat_frame_buffer *buffer) {
+    memcpy(buffer->data, palette, sizeof(palette));
+
+    buffer->img = (lv_img_dsc_t){
+        .header.cf = LV_IMG_CF_INDEXED_1BIT,
+        .header.always_zero = 0,
+        .header.reserved = 0,
+        .header.w = BONGO_CAT_WIDTH,
+        .header.h = BONGO_CAT_HEIGHT,
+        .data_size = sizeof(buffer->data),
+        .data = buffer->data,
+    };
+
+    // the first show starts from a copy of the keyframe
+    buffer->current = BONGO_CAT_FRAME_COUNT;
+}
+
+bool bongo_cat_frame_show(struct bongo_cat_frame_buffer *buffer, enum bongo_cat_frame frame,
+                          uint8_t *first_row, uint8_t *last_row) {
+    uint8_t *pixels = &buffer->data[BONGO_CAT_PALETTE_SIZE];
+    int lo = BONGO_CAT_FRAME_SIZE;
+    int hi = -1;
+
+    if (frame >= BONGO_CAT_FRAME_COUNT || frame == buffer->current) {
+        return false;
+    }
+
+    if (buffer->current == BONGO_CAT_FRAME_COUNT) {
+        memcpy(pixels, bongo_cat_keyframe, BONGO_CAT_FRAME_SIZE);
+        lo = 0;
+        hi = BONGO_CAT_FRAME_SIZE - 1;
+    } else {
+        // XOR is its own inverse: undo the current delta to get back to the keyframe
+        apply_delta(pixels, bongo_cat_deltas[buffer->current], &lo, &hi);
+    }
+
+    apply_delta(pixels, bongo_cat_deltas[frame], &lo, &hi);
+    buffer->current = frame;
+
+    // LVGL may hold a cached decode of the buffer
+    lv_img_cache_invalidate_src(&buffer->img);
+
+    if (hi < lo) {
+        // frames with identical pixels
+        lo = hi = 0;
+    }
+
+    if (first_row != NULL) {
+        *first_row = lo / BONGO_CAT_STRIDE;
+    }
+    if (last_row != NULL) {
+        *last_row = hi / BONGO_CAT_STRIDE;
+    }
+
+    return true;
+}
+
+void bongo_cat_frame_invalidate(lv_obj_t *img, uint8_t first_row, uint8_t last_row) {
+    lv_area_t area;
+
+    lv_obj_get_coords(img, &area);
+    area.y2 = area.y1 + last_row;
+    area.y1 += first_row;
+
+    lv_obj_invalidate_area(img, &area);
+}
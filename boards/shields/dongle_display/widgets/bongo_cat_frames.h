@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#if !IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE)
+#include <lvgl.h>
+#endif
+
+#define BONGO_CAT_WIDTH 50
+#define BONGO_CAT_HEIGHT 26
+#define BONGO_CAT_STRIDE ((BONGO_CAT_WIDTH + 7) / 8)
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE)
+// the lite renderer keeps the frames in display page order, 8 rows per byte
+#define BONGO_CAT_FRAME_SIZE (BONGO_CAT_WIDTH * DIV_ROUND_UP(BONGO_CAT_HEIGHT, 8))
+#else
+#define BONGO_CAT_FRAME_SIZE (BONGO_CAT_STRIDE * BONGO_CAT_HEIGHT)
+#endif
+
+enum bongo_cat_frame {
+    BONGO_CAT_NONE,       // both hands in the air, cheery
+    BONGO_CAT_LEFT1,      // left hand only on table
+    BONGO_CAT_LEFT2,      // left hand only on table, hitting
+    BONGO_CAT_RIGHT1,     // right hand only on table
+    BONGO_CAT_RIGHT2,     // right hand only on table, hitting
+    BONGO_CAT_BOTH1,      // both hands resting on table, cheery
+    BONGO_CAT_BOTH1_OPEN, // both hands resting on table, plain face
+    BONGO_CAT_BOTH2,      // both hands hitting table
+    BONGO_CAT_FRAME_COUNT,
+};
+
+// Every frame is stored as an XOR delta against a single 1 bpp keyframe. A delta is a list of
+// (skip, length, length bytes) runs over the packed pixel bytes, terminated by a 0, 0 run.
+// bongo_cat_frames.c is generated at build time by scripts/png_to_lvgl.py from assets/bongo_cat,
+// in the order of this enum.
+extern const uint8_t bongo_cat_keyframe[BONGO_CAT_FRAME_SIZE];
+extern const uint8_t *const bongo_cat_deltas[BONGO_CAT_FRAME_COUNT];
+
+#if !IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE)
+
+#define BONGO_CAT_PALETTE_SIZE 8
+
+// Decode buffer of one bongo cat, owned by the caller so that several cats animate independently
+struct bongo_cat_frame_buffer {
+    // palette of the original images followed by the packed pixels
+    uint8_t data[BONGO_CAT_PALETTE_SIZE + BONGO_CAT_FRAME_SIZE];
+    lv_img_dsc_t img;
+    // the decoded frame, BONGO_CAT_FRAME_COUNT before the first one
+    enum bongo_cat_frame current;
+};
+
+// Sets up the palette and the image descriptor backed by the buffer, nothing is decoded yet.
+void bongo_cat_frame_init(struct bongo_cat_frame_buffer *buffer);
+
+// Decodes frame into the buffer in place. Returns false if it was already shown, otherwise the
+// range of pixel rows that changed is stored in first_row/last_row when those are not NULL.
+bool bongo_cat_frame_show(struct bongo_cat_frame_buffer *buffer, enum bongo_cat_frame frame,
+                          uint8_t *first_row, uint8_t *last_row);
+
+// Invalidates only the changed rows of an image showing a frame buffer.
+void bongo_cat_frame_invalidate(lv_obj_t *img, uint8_t first_row, uint8_t last_row);
+
+#endif /* !IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RENDERER_LITE) */
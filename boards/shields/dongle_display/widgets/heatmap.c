@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "display/anim_sched.h"
+#include "display/heatmap_store.h"
+#include "display/key_position.h"
+#include "display/obj_update.h"
+#include "display/widget.h"
+
+// the page is as large as its rect, usually the whole screen
+#define HEATMAP_WIDTH DONGLE_WIDGET_WIDTH(heatmap)
+#define HEATMAP_HEIGHT DONGLE_WIDGET_HEIGHT(heatmap)
+#define HEATMAP_STRIDE ((HEATMAP_WIDTH + 7) / 8)
+
+// Cells shrink with the declared matrix. Transforms may use an offset range of it, such as
+// columns 1 to 10 of 10, the grid is laid out from the rows and columns actually in use.
+BUILD_ASSERT(HEATMAP_WIDTH / DONGLE_KEY_MATRIX_COLUMNS >= 3 &&
+                 HEATMAP_HEIGHT / DONGLE_KEY_MATRIX_ROWS >= 3,
+             "the matrix is too large for a heatmap on this display");
+
+#define PALETTE_SIZE 8
+
+// 4x4 ordered dither thresholds, a key lights 0 to 16 of every 16 pixels
+#define LEVELS 16
+
+static const uint8_t bayer[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+// Same palette as the bongo cat: index 0 white, index 1 black
+static uint8_t heatmap_buffer[PALETTE_SIZE + HEATMAP_STRIDE * HEATMAP_HEIGHT] = {
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0xff,
+};
+
+static const lv_img_dsc_t heatmap_img = {
+    .header.cf = LV_IMG_CF_INDEXED_1BIT,
+    .header.always_zero = 0,
+    .header.reserved = 0,
+    .header.w = HEATMAP_WIDTH,
+    .header.h = HEATMAP_HEIGHT,
+    .data_size = sizeof(heatmap_buffer),
+    .data = heatmap_buffer,
+};
+
+static lv_obj_t *img;
+
+// the grid of the keys in use, set up once by heatmap_create
+static struct {
+    uint8_t first_row;
+    uint8_t first_col;
+    uint8_t cell_width;
+    uint8_t cell_height;
+} grid;
+
+static struct dongle_anim_deadline refresh;
+static bool visible;
+
+// press generation the image was last drawn for
+static uint32_t drawn_presses = UINT32_MAX;
+
+static inline void set_pixel(uint8_t *pixels, int x, int y) {
+    pixels[y * HEATMAP_STRIDE + x / 8] |= BIT(7 - (x % 8));
+}
+
+static void draw_key(uint8_t *pixels, const struct dongle_key_position *key, uint8_t level) {
+    // one pixel gap to the next cell on the right and below, never past the edge of the page
+    int x0 = (key->col - grid.first_col) * grid.cell_width;
+    int y0 = (key->row - grid.first_row) * grid.cell_height;
+    int x1 = MIN(x0 + grid.cell_width - 1, HEATMAP_WIDTH);
+    int y1 = MIN(y0 + grid.cell_height - 1, HEATMAP_HEIGHT);
+
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    if (level == 0) {
+        // unused keys keep a base line so the layout stays readable
+        for (int x = x0; x < x1; x++) {
+            set_pixel(pixels, x, y1 - 1);
+        }
+        return;
+    }
+
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            if (bayer[y & 3][x & 3] < level) {
+                set_pixel(pixels, x, y);
+            }
+        }
+    }
+}
+
+static void render(void) {
+    static uint32_t counts[DONGLE_KEY_POSITION_COUNT];
+    struct dongle_heatmap_stats stats;
+    uint8_t *pixels = &heatmap_buffer[PALETTE_SIZE];
+
+    dongle_heatmap_get_stats(&stats);
+    if (stats.presses == drawn_presses) {
+        return;
+    }
+    drawn_presses = stats.presses;
+
+    uint32_t max = dongle_heatmap_snapshot(counts);
+
+    memset(pixels, 0, HEATMAP_STRIDE * HEATMAP_HEIGHT);
+
+    for (int i = 0; i < DONGLE_KEY_POSITION_COUNT; i++) {
+        const struct dongle_key_position *key = dongle_key_position_get(i);
+        // any press lights at least one pixel in 16, the busiest key is solid
+        uint8_t level = counts[i] == 0 ? 0 : 1 + (uint64_t)counts[i] * (LEVELS - 1) / max;
+
+        draw_key(pixels, key, level);
+    }
+
+    lv_img_cache_invalidate_src(&heatmap_img);
+    lv_obj_invalidate(img);
+}
+
+static void refresh_handler(struct dongle_anim_deadline *deadline) {
+    render();
+    dongle_anim_schedule_at(deadline, deadline->due + CONFIG_ZMK_DONGLE_DISPLAY_HEATMAP_REFRESH);
+}
+
+static void heatmap_render(const struct dongle_status *status, uint32_t changed) {
+    bool shown = status->layer == CONFIG_ZMK_DONGLE_DISPLAY_HEATMAP_LAYER;
+
+    if (shown == visible) {
+        return;
+    }
+
+    visible = shown;
+
+    if (visible) {
+        render();
+        dongle_anim_schedule_at(&refresh,
+                                k_uptime_get() + CONFIG_ZMK_DONGLE_DISPLAY_HEATMAP_REFRESH);
+    } else {
+        dongle_anim_cancel(&refresh);
+    }
+
+    // widgets reloaded after ambient mode were created above the page
+    if (visible) {
+        lv_obj_move_foreground(img);
+    }
+    dongle_obj_set_hidden(img, !visible);
+}
+
+static void layout_grid(void) {
+    uint8_t last_row = 0, last_col = 0;
+
+    grid.first_row = UINT8_MAX;
+    grid.first_col = UINT8_MAX;
+
+    for (int i = 0; i < DONGLE_KEY_POSITION_COUNT; i++) {
+        const struct dongle_key_position *key = dongle_key_position_get(i);
+
+        grid.first_row = MIN(grid.first_row, key->row);
+        grid.first_col = MIN(grid.first_col, key->col);
+        last_row = MAX(last_row, key->row);
+        last_col = MAX(last_col, key->col);
+    }
+
+    if (grid.first_row > last_row) {
+        // no keys, nothing is drawn
+        grid.first_row = grid.first_col = 0;
+    }
+
+    grid.cell_width = HEATMAP_WIDTH / (last_col - grid.first_col + 1);
+    grid.cell_height = HEATMAP_HEIGHT / (last_row - grid.first_row + 1);
+}
+
+static lv_obj_t *heatmap_create(lv_obj_t *parent) {
+    layout_grid();
+
+    img = lv_img_create(parent);
+    lv_obj_set_pos(img, DONGLE_WIDGET_X(heatmap), DONGLE_WIDGET_Y(heatmap));
+    lv_img_set_src(img, &heatmap_img);
+    lv_obj_add_flag(img, LV_OBJ_FLAG_HIDDEN);
+
+    dongle_anim_deadline_init(&refresh, refresh_handler);
+
+    return img;
+}
+
+// last, the page covers the other widgets
+DONGLE_WIDGET_DEFINE(heatmap, 90, DONGLE_REGION_HEATMAP, DONGLE_WIDGET_AMBIENT,
+                     DONGLE_STATUS_BIT(LAYER), heatmap_create, NULL, heatmap_render);
@@ -9,62 +9,32 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/display/widgets/layer_status.h>
-#include <zmk/events/layer_state_changed.h>
-#include <zmk/event_manager.h>
-#include <zmk/endpoints.h>
-#include <zmk/keymap.h>
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+#include "display/latency.h"
+#include "display/obj_update.h"
+#include "display/text_cache.h"
+#include "display/widget.h"
 
-struct layer_status_state {
-    uint8_t index;
-    const char *label;
-};
+static lv_obj_t *label;
 
-static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state) {
-    if (state.label == NULL) {
-        char text[7] = {};
-
-        sprintf(text, "%i", state.index);
-
-        lv_label_set_text(label, text);
-    } else {
-        char text[13] = {};
-
-        snprintf(text, sizeof(text), "%s", state.label);
-
-        lv_label_set_text(label, text);
+static void layer_status_render(const struct dongle_status *status, uint32_t changed) {
+    if (changed & DONGLE_STATUS_BIT(LAYER)) {
+        dongle_latency_mark(DONGLE_REGION_LAYER, status->changed_at[DONGLE_STATUS_LAYER]);
     }
-}
 
-static void layer_status_update_cb(struct layer_status_state state) {
-    struct zmk_widget_layer_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_layer_symbol(widget->obj, state); }
-}
+    dongle_label_set_text_static(label, dongle_text_layer(status->layer));
 
-static struct layer_status_state layer_status_get_state(const zmk_event_t *eh) {
-    uint8_t index = zmk_keymap_highest_layer_active();
-    return (struct layer_status_state) {
-        .index = index,
-        .label = zmk_keymap_layer_name(index)
-    };
+    if (changed & DONGLE_STATUS_BIT(LAYER)) {
+        dongle_latency_applied(DONGLE_REGION_LAYER);
+    }
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, layer_status_update_cb,
-                            layer_status_get_state)
-
-ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
-
-int zmk_widget_layer_status_init(struct zmk_widget_layer_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
-
-    sys_slist_append(&widgets, &widget->node);
-
-    widget_layer_status_init();
-    return 0;
+static lv_obj_t *layer_status_create(lv_obj_t *parent) {
+    label = lv_label_create(parent);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_CLIP);
+    DONGLE_WIDGET_SET_RECT(label, layer_status);
+    return label;
 }
 
-lv_obj_t *zmk_widget_layer_status_obj(struct zmk_widget_layer_status *widget) {
-    return widget->obj;
-}
\ No newline at end of file
+DONGLE_WIDGET_DEFINE(layer_status, 40, DONGLE_REGION_LAYER, DONGLE_WIDGET_AMBIENT,
+                     DONGLE_STATUS_BIT(LAYER), layer_status_create, NULL, layer_status_render);
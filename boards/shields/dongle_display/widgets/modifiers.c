@@ -11,16 +11,18 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/event_manager.h>
-#include <zmk/events/keycode_state_changed.h>
-#include <zmk/hid.h>
 #include <dt-bindings/zmk/modifiers.h>
 
-#include "modifiers.h"
+#include "display/latency.h"
+#include "display/motion.h"
+#include "display/obj_update.h"
+#include "display/widget.h"
 
-struct modifiers_state {    
-    uint8_t modifiers;
-};
+#define SIZE_SYMBOLS 14 // 14 x 14 pixel
+
+// symbols and selection lines sit straight on the screen, offset from the rect origin
+#define MODIFIERS_X DONGLE_WIDGET_X(modifiers)
+#define MODIFIERS_Y DONGLE_WIDGET_Y(modifiers)
 
 struct modifier_symbol {    
     uint8_t modifier;
@@ -86,84 +88,88 @@ struct modifier_symbol *modifier_symbols[] = {
 
 #define NUM_SYMBOLS (sizeof(modifier_symbols) / sizeof(struct modifier_symbol *))
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+BUILD_ASSERT(DONGLE_WIDGET_WIDTH(modifiers) >= NUM_SYMBOLS * (SIZE_SYMBOLS + 1) + 1 &&
+                 DONGLE_WIDGET_HEIGHT(modifiers) >= SIZE_SYMBOLS + 3,
+             "the modifiers rect is too small for the symbols");
 
 static void anim_y_cb(void *var, int32_t v) {
     lv_obj_set_y(var, v);
 }
 
+// a toggle while the previous one still moves retargets it, bursts of home row mods never stack
 static void move_object_y(void *obj, int32_t from, int32_t to) {
-    lv_anim_t a;
-    lv_anim_init(&a);
-    lv_anim_set_var(&a, obj);
-    lv_anim_set_time(&a, 200); // will be replaced with lv_anim_set_duration
-    lv_anim_set_exec_cb(&a, anim_y_cb);
-    lv_anim_set_path_cb(&a, lv_anim_path_overshoot);
-    lv_anim_set_values(&a, from, to);
-    lv_anim_start(&a);
+    dongle_motion_animate(obj, anim_y_cb, lv_anim_path_overshoot, 200, from, to);
 }
 
-static void set_modifiers(lv_obj_t *widget, struct modifiers_state state) {
+static void set_modifiers(uint8_t modifiers) {
     for (int i = 0; i < NUM_SYMBOLS; i++) {
-        bool mod_is_active = state.modifiers & modifier_symbols[i]->modifier;
+        bool mod_is_active = modifiers & modifier_symbols[i]->modifier;
 
         if (mod_is_active && !modifier_symbols[i]->is_active) {
-            move_object_y(modifier_symbols[i]->symbol, 1, 0);
-            move_object_y(modifier_symbols[i]->selection_line, SIZE_SYMBOLS + 4, SIZE_SYMBOLS + 2);
+            move_object_y(modifier_symbols[i]->symbol, MODIFIERS_Y + 1, MODIFIERS_Y);
+            dongle_obj_set_hidden(modifier_symbols[i]->selection_line, false);
+            move_object_y(modifier_symbols[i]->selection_line, MODIFIERS_Y + SIZE_SYMBOLS + 4,
+                          MODIFIERS_Y + SIZE_SYMBOLS + 2);
             modifier_symbols[i]->is_active = true;
         } else if (!mod_is_active && modifier_symbols[i]->is_active) {
-            move_object_y(modifier_symbols[i]->symbol, 0, 1);
-            move_object_y(modifier_symbols[i]->selection_line, SIZE_SYMBOLS + 2, SIZE_SYMBOLS + 4);
+            move_object_y(modifier_symbols[i]->symbol, MODIFIERS_Y, MODIFIERS_Y + 1);
+            // no container clips the line below the rect anymore, it goes away at once
+            dongle_obj_set_hidden(modifier_symbols[i]->selection_line, true);
             modifier_symbols[i]->is_active = false;
         }
     }
 }
 
-void modifiers_update_cb(struct modifiers_state state) {
-    struct zmk_widget_modifiers *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_modifiers(widget->obj, state); }
-}
-
-static struct modifiers_state modifiers_get_state(const zmk_event_t *eh) {
-    return (struct modifiers_state) {
-        .modifiers = zmk_hid_get_explicit_mods()
-    };
-}
+static void modifiers_render(const struct dongle_status *status, uint32_t changed) {
+    if (changed & DONGLE_STATUS_BIT(MODS)) {
+        dongle_latency_mark(DONGLE_REGION_MODIFIERS, status->changed_at[DONGLE_STATUS_MODS]);
+    }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_modifiers, struct modifiers_state,
-                            modifiers_update_cb, modifiers_get_state)
+    set_modifiers(status->mods);
 
-ZMK_SUBSCRIPTION(widget_modifiers, zmk_keycode_state_changed);
+    if (changed & DONGLE_STATUS_BIT(MODS)) {
+        dongle_latency_applied(DONGLE_REGION_MODIFIERS);
+    }
+}
 
-int zmk_widget_modifiers_init(struct zmk_widget_modifiers *widget, lv_obj_t *parent) {
-    widget->obj = lv_obj_create(parent);
+static const lv_style_const_prop_t line_props[] = {
+    LV_STYLE_CONST_LINE_WIDTH(2),
+    LV_STYLE_PROP_INV,
+};
 
-    lv_obj_set_size(widget->obj, NUM_SYMBOLS * (SIZE_SYMBOLS + 1) + 1, SIZE_SYMBOLS + 3);
-    
-    static lv_style_t style_line;
-    lv_style_init(&style_line);
-    lv_style_set_line_width(&style_line, 2);
+static LV_STYLE_CONST_INIT(style_line, line_props);
 
+static lv_obj_t *modifiers_create(lv_obj_t *parent) {
     static const lv_point_t selection_line_points[] = { {0, 0}, {SIZE_SYMBOLS, 0} };
 
     for (int i = 0; i < NUM_SYMBOLS; i++) {
-        modifier_symbols[i]->symbol = lv_img_create(widget->obj);
-        lv_obj_align(modifier_symbols[i]->symbol, LV_ALIGN_TOP_LEFT, 1 + (SIZE_SYMBOLS + 1) * i, 1);
+        int x = MODIFIERS_X + 1 + (SIZE_SYMBOLS + 1) * i;
+
+        modifier_symbols[i]->symbol = lv_img_create(parent);
+        lv_obj_set_pos(modifier_symbols[i]->symbol, x, MODIFIERS_Y + 1);
         lv_img_set_src(modifier_symbols[i]->symbol, modifier_symbols[i]->symbol_dsc);
 
-        modifier_symbols[i]->selection_line = lv_line_create(widget->obj);
+        modifier_symbols[i]->selection_line = lv_line_create(parent);
         lv_line_set_points(modifier_symbols[i]->selection_line, selection_line_points, 2);
-        lv_obj_add_style(modifier_symbols[i]->selection_line, &style_line, 0);
-        lv_obj_align_to(modifier_symbols[i]->selection_line, modifier_symbols[i]->symbol, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 3);
+        lv_obj_add_style(modifier_symbols[i]->selection_line, (lv_style_t *)&style_line, 0);
+        lv_obj_set_pos(modifier_symbols[i]->selection_line, x, MODIFIERS_Y + SIZE_SYMBOLS + 4);
+        lv_obj_add_flag(modifier_symbols[i]->selection_line, LV_OBJ_FLAG_HIDDEN);
     }
 
-    sys_slist_append(&widgets, &widget->node);
-
-    widget_modifiers_init();
+    return NULL;
+}
 
-    return 0;
+static void modifiers_destroy(void) {
+    for (int i = 0; i < NUM_SYMBOLS; i++) {
+        // deleting an object also deletes its running animations
+        lv_obj_del(modifier_symbols[i]->symbol);
+        lv_obj_del(modifier_symbols[i]->selection_line);
+        modifier_symbols[i]->symbol = NULL;
+        modifier_symbols[i]->selection_line = NULL;
+        modifier_symbols[i]->is_active = false;
+    }
 }
 
-lv_obj_t *zmk_widget_modifiers_obj(struct zmk_widget_modifiers *widget) {
-    return widget->obj;
-}
\ No newline at end of file
+DONGLE_WIDGET_DEFINE(modifiers, 20, DONGLE_REGION_MODIFIERS, DONGLE_WIDGET_UNLOAD,
+                     DONGLE_STATUS_BIT(MODS), modifiers_create, modifiers_destroy,
+                     modifiers_render);
@@ -10,17 +10,16 @@
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/event_manager.h>
-#include <zmk/events/ble_active_profile_changed.h>
-#include <zmk/events/endpoint_changed.h>
-#include <zmk/events/usb_conn_state_changed.h>
-#include <zmk/usb.h>
-#include <zmk/ble.h>
-#include <zmk/endpoints.h>
 
-#include "output_status.h"
+#include "display/motion.h"
+#include "display/obj_update.h"
+#include "display/widget.h"
 
-static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+#define OUTPUT_X DONGLE_WIDGET_X(output_status)
+#define OUTPUT_Y DONGLE_WIDGET_Y(output_status)
+
+BUILD_ASSERT(DONGLE_WIDGET_WIDTH(output_status) >= 32 && DONGLE_WIDGET_HEIGHT(output_status) >= 18,
+             "the output_status rect is too small for the symbols");
 
 LV_IMG_DECLARE(sym_usb);
 LV_IMG_DECLARE(sym_bt);
@@ -47,9 +46,13 @@ enum output_symbol {
     output_symbol_bt,
     output_symbol_bt_number,
     output_symbol_bt_status,
-    output_symbol_selection_line
+    output_symbol_selection_line,
+    output_symbol_count
 };
 
+// straight on the screen, positioned from the rect origin
+static lv_obj_t *symbols[output_symbol_count];
+
 enum selection_line_state {
     selection_line_state_usb,
     selection_line_state_bt
@@ -57,24 +60,6 @@ enum selection_line_state {
 
 lv_point_t selection_line_points[] = { {0, 0}, {13, 0} }; // will be replaced with lv_point_precise_t 
 
-struct output_status_state {
-    struct zmk_endpoint_instance selected_endpoint;
-    int active_profile_index;
-    bool active_profile_connected;
-    bool active_profile_bonded;
-    bool usb_is_hid_ready;
-};
-
-static struct output_status_state get_state(const zmk_event_t *_eh) {
-    return (struct output_status_state){
-        .selected_endpoint = zmk_endpoints_selected(),
-        .active_profile_index = zmk_ble_active_profile_index(),
-        .active_profile_connected = zmk_ble_active_profile_is_connected(),
-        .active_profile_bonded = !zmk_ble_active_profile_is_open(),
-        .usb_is_hid_ready = zmk_usb_is_hid_ready()
-    };
-}
-
 static void anim_x_cb(void * var, int32_t v) {
     lv_obj_set_x(var, v);
 }
@@ -84,36 +69,22 @@ static void anim_size_cb(void * var, int32_t v) {
 }
 
 static void move_object_x(void *obj, int32_t from, int32_t to) {
-    lv_anim_t a;
-    lv_anim_init(&a);
-    lv_anim_set_var(&a, obj);
-    lv_anim_set_time(&a, 200); // will be replaced with lv_anim_set_duration
-    lv_anim_set_exec_cb(&a, anim_x_cb);
-    lv_anim_set_path_cb(&a, lv_anim_path_overshoot);
-    lv_anim_set_values(&a, from, to);
-    lv_anim_start(&a);
+    dongle_motion_animate(obj, anim_x_cb, lv_anim_path_overshoot, 200, from, to);
 }
 
 static void change_size_object(void *obj, int32_t from, int32_t to) {
-    lv_anim_t a;
-    lv_anim_init(&a);
-    lv_anim_set_var(&a, obj);
-    lv_anim_set_time(&a, 200); // will be replaced with lv_anim_set_duration
-    lv_anim_set_exec_cb(&a, anim_size_cb);
-    lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
-    lv_anim_set_values(&a, from, to);
-    lv_anim_start(&a);
+    dongle_motion_animate(obj, anim_size_cb, lv_anim_path_ease_in_out, 200, from, to);
 }
 
-static void set_status_symbol(lv_obj_t *widget, struct output_status_state state) {
-    lv_obj_t *usb = lv_obj_get_child(widget, output_symbol_usb);
-    lv_obj_t *usb_hid_status = lv_obj_get_child(widget, output_symbol_usb_hid_status);
-    lv_obj_t *bt = lv_obj_get_child(widget, output_symbol_bt);
-    lv_obj_t *bt_number = lv_obj_get_child(widget, output_symbol_bt_number);
-    lv_obj_t *bt_status = lv_obj_get_child(widget, output_symbol_bt_status);
-    lv_obj_t *selection_line = lv_obj_get_child(widget, output_symbol_selection_line);
+static void set_status_symbol(const struct dongle_status_output *state) {
+    lv_obj_t *usb = symbols[output_symbol_usb];
+    lv_obj_t *usb_hid_status = symbols[output_symbol_usb_hid_status];
+    lv_obj_t *bt = symbols[output_symbol_bt];
+    lv_obj_t *bt_number = symbols[output_symbol_bt_number];
+    lv_obj_t *bt_status = symbols[output_symbol_bt_status];
+    lv_obj_t *selection_line = symbols[output_symbol_selection_line];
 
-    switch (state.selected_endpoint.transport) {
+    switch (state->endpoint.transport) {
     case ZMK_TRANSPORT_USB:
         if (current_selection_line_state != selection_line_state_usb) {
             move_object_x(selection_line, lv_obj_get_x(bt) - 1, lv_obj_get_x(usb) - 1);
@@ -130,78 +101,87 @@ static void set_status_symbol(lv_obj_t *widget, struct output_status_state state
         break;
     }
 
-    if (state.usb_is_hid_ready) {
-        lv_img_set_src(usb_hid_status, &sym_ok);
+    if (state->usb_hid_ready) {
+        dongle_img_set_src(usb_hid_status, &sym_ok);
     } else {
-        lv_img_set_src(usb_hid_status, &sym_nok);
+        dongle_img_set_src(usb_hid_status, &sym_nok);
     }
 
-    if (state.active_profile_index < (sizeof(sym_num) / sizeof(lv_img_dsc_t *))) {
-        lv_img_set_src(bt_number, sym_num[state.active_profile_index]);
+    if (state->profile_index < (sizeof(sym_num) / sizeof(lv_img_dsc_t *))) {
+        dongle_img_set_src(bt_number, sym_num[state->profile_index]);
     } else {
-        lv_img_set_src(bt_number, &sym_nok);
+        dongle_img_set_src(bt_number, &sym_nok);
     }
     
-    if (state.active_profile_bonded) {
-        if (state.active_profile_connected) {
-            lv_img_set_src(bt_status, &sym_ok);
+    if (state->bonded) {
+        if (state->connected) {
+            dongle_img_set_src(bt_status, &sym_ok);
         } else {
-            lv_img_set_src(bt_status, &sym_nok);
+            dongle_img_set_src(bt_status, &sym_nok);
         }
     } else {
-        lv_img_set_src(bt_status, &sym_open);
+        dongle_img_set_src(bt_status, &sym_open);
     }
 }
 
-static void output_status_update_cb(struct output_status_state state) {
-    struct zmk_widget_output_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_status_symbol(widget->obj, state); }
+static void output_status_render(const struct dongle_status *status, uint32_t changed) {
+    set_status_symbol(&status->output);
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_output_status, struct output_status_state,
-                            output_status_update_cb, get_state)
-ZMK_SUBSCRIPTION(widget_output_status, zmk_endpoint_changed);
-ZMK_SUBSCRIPTION(widget_output_status, zmk_ble_active_profile_changed);
-ZMK_SUBSCRIPTION(widget_output_status, zmk_usb_conn_state_changed);
-
-int zmk_widget_output_status_init(struct zmk_widget_output_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_obj_create(parent);
+static const lv_style_const_prop_t line_props[] = {
+    LV_STYLE_CONST_LINE_WIDTH(2),
+    LV_STYLE_PROP_INV,
+};
 
-    lv_obj_set_size(widget->obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+static LV_STYLE_CONST_INIT(style_line, line_props);
 
-    lv_obj_t *usb = lv_img_create(widget->obj);
-    lv_obj_align(usb, LV_ALIGN_TOP_LEFT, 1, 4);
+static lv_obj_t *output_status_create(lv_obj_t *parent) {
+    // fixed offsets of the 9 x 14 usb and bt symbols and the 5 px status symbols next to them
+    lv_obj_t *usb = lv_img_create(parent);
+    lv_obj_set_pos(usb, OUTPUT_X + 1, OUTPUT_Y + 4);
     lv_img_set_src(usb, &sym_usb);
 
-    lv_obj_t *usb_hid_status = lv_img_create(widget->obj);
-    lv_obj_align_to(usb_hid_status, usb, LV_ALIGN_BOTTOM_LEFT, 2, -7);
+    lv_obj_t *usb_hid_status = lv_img_create(parent);
+    lv_obj_set_pos(usb_hid_status, OUTPUT_X + 3, OUTPUT_Y + 11);
 
-    lv_obj_t *bt = lv_img_create(widget->obj);
-    lv_obj_align_to(bt, usb, LV_ALIGN_OUT_RIGHT_TOP, 6, 0);
+    lv_obj_t *bt = lv_img_create(parent);
+    lv_obj_set_pos(bt, OUTPUT_X + 16, OUTPUT_Y + 4);
     lv_img_set_src(bt, &sym_bt);
 
-    lv_obj_t *bt_number = lv_img_create(widget->obj);
-    lv_obj_align_to(bt_number, bt, LV_ALIGN_OUT_RIGHT_TOP, 2, 7);
+    lv_obj_t *bt_number = lv_img_create(parent);
+    lv_obj_set_pos(bt_number, OUTPUT_X + 27, OUTPUT_Y + 11);
 
-    lv_obj_t *bt_status = lv_img_create(widget->obj);
-    lv_obj_align_to(bt_status, bt, LV_ALIGN_OUT_RIGHT_TOP, 2, 1);
+    lv_obj_t *bt_status = lv_img_create(parent);
+    lv_obj_set_pos(bt_status, OUTPUT_X + 27, OUTPUT_Y + 5);
     
-    static lv_style_t style_line;
-    lv_style_init(&style_line);
-    lv_style_set_line_width(&style_line, 2);
-
     lv_obj_t *selection_line;
-    selection_line = lv_line_create(widget->obj);
+    selection_line = lv_line_create(parent);
     lv_line_set_points(selection_line, selection_line_points, 2);
-    lv_obj_add_style(selection_line, &style_line, 0);
-    lv_obj_align_to(selection_line, usb, LV_ALIGN_OUT_TOP_LEFT, 3, -1);
+    lv_obj_add_style(selection_line, (lv_style_t *)&style_line, 0);
+    lv_obj_set_pos(selection_line, OUTPUT_X + 4, OUTPUT_Y + 1);
+
+    symbols[output_symbol_usb] = usb;
+    symbols[output_symbol_usb_hid_status] = usb_hid_status;
+    symbols[output_symbol_bt] = bt;
+    symbols[output_symbol_bt_number] = bt_number;
+    symbols[output_symbol_bt_status] = bt_status;
+    symbols[output_symbol_selection_line] = selection_line;
+
+    // the line starts under the usb symbol again
+    current_selection_line_state = selection_line_state_usb;
+    selection_line_points[1].x = 13;
  
-    sys_slist_append(&widgets, &widget->node);
-
-    widget_output_status_init();
-    return 0;
+    return NULL;
 }
 
-lv_obj_t *zmk_widget_output_status_obj(struct zmk_widget_output_status *widget) {
-    return widget->obj;
+static void output_status_destroy(void) {
+    // several objects and nothing to hide them under, the widget goes away in ambient mode
+    for (int i = 0; i < output_symbol_count; i++) {
+        lv_obj_del(symbols[i]);
+        symbols[i] = NULL;
+    }
 }
+
+DONGLE_WIDGET_DEFINE(output_status, 60, DONGLE_REGION_OUTPUT, DONGLE_WIDGET_UNLOAD,
+                     DONGLE_STATUS_BIT(OUTPUT), output_status_create, output_status_destroy,
+                     output_status_render);